@@ -0,0 +1,80 @@
+#include "../ulib.h"
+
+#define NUM_OF_ELEMENTS 10000
+
+typedef struct {
+    pid_t pid;
+    int state;
+    char *name;
+} Process;
+
+ARRAY_DEFINE(IntArray, intArray, int)
+ARRAY_DEFINE(ProcessArray, processArray, Process)
+
+static void processRelease(Process *process)
+{
+    objectRelease(&process->name);
+}
+
+int main()
+{
+    // test an array of integers
+    IntArray *intArr = intArrayNew(NULL);
+    for (int i = 0; i < NUM_OF_ELEMENTS; i++) {
+        bool added = intArrayAdd(intArr, i);
+        assert(added);
+    }
+    assert(intArr->size == NUM_OF_ELEMENTS && intArr->capacity >= NUM_OF_ELEMENTS);
+    for (int i = 0; i < NUM_OF_ELEMENTS; i++)
+        assert(*intArrayGet(intArr, i) == i);
+    assert(!intArrayGet(intArr, NUM_OF_ELEMENTS) && !intArrayGet(intArr, -1));
+    bool res = intArrayInsertAt(intArr, 0, -1);
+    assert(res && *intArrayGet(intArr, 0) == -1);
+    res = intArrayInsertAt(intArr, intArr->size + 1, 0);
+    assert(!res);
+    res = intArrayRemoveAt(intArr, 0);
+    assert(res && *intArrayGet(intArr, 0) == 0);
+    res = intArraySet(intArr, 42, 5);
+    assert(res && *intArrayGet(intArr, 5) == 42);
+    *intArrayGet(intArr, 6) = 43;
+    assert(intArr->arr[6] == 43);
+    for (int i = 0; i < NUM_OF_ELEMENTS - 10; i++) {
+        res = intArrayRemoveAt(intArr, intArr->size - 1);
+        assert(res);
+    }
+    res = intArrayShrinkToFit(intArr);
+    assert(res && intArr->capacity == 10);
+    res = intArrayReserve(intArr, 100);
+    assert(res && intArr->capacity == 100);
+    intArrayRelease(&intArr);
+    assert(!intArr);
+
+    // test an array of structures with a release function
+    ProcessArray *processArr = processArrayNew(processRelease);
+    for (int i = 0; i < 100; i++) {
+        char name[30];
+        snprintf(name, sizeof(name), "process%d", i);
+        Process process = { .pid = 1000 + i, .state = i % 3, .name = stringNew(name) };
+        res = processArrayAdd(processArr, process);
+        assert(res);
+    }
+    Process *process = processArrayGet(processArr, 50);
+    printf("Pid = %d, state = %d, name = %s\n", process->pid, process->state, process->name);
+    assert(process->pid == 1050 && stringEquals(process->name, "process50"));
+    res = processArrayRemoveAt(processArr, 50);
+    assert(res);
+    assert(processArrayGet(processArr, 50)->pid == 1051);
+    Process newProcess = { .pid = 1, .state = 0, .name = stringNew("init") };
+    res = processArraySet(processArr, newProcess, 0);
+    assert(res);
+    assert(stringEquals(processArrayGet(processArr, 0)->name, "init"));
+    processArrayRelease(&processArr);
+
+    // test an empty array
+    processArr = processArrayNew(processRelease);
+    res = processArrayRemoveAt(processArr, 0);
+    assert(!res);
+    res = processArrayShrinkToFit(processArr);
+    assert(res);
+    processArrayRelease(&processArr);
+}
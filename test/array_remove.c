@@ -0,0 +1,69 @@
+#include "../ulib.h"
+
+#define NUM_OF_ELEMENTS 50000
+
+static bool isMultiple(void *element, void *data)
+{
+    return atoi(element) % *(int *)data == 0;
+}
+
+static Array *arrayFill(int numOfElements)
+{
+    Array *arr = arrayNew(objectRelease);
+    for (int i = 0; i < numOfElements; i++) {
+        char str[20];
+        sprintf(str, "%d", i);
+        arrayAdd(arr, stringNew(str));
+    }
+
+    return arr;
+}
+
+int main()
+{
+    // test the swap remotion
+    Array *arr = arrayFill(10);
+    bool removed = arraySwapRemoveAt(arr, 2);
+    assert(removed && arr->size == 9 && stringEquals(arrayGet(arr, 2), "9"));
+    removed = arraySwapRemoveAt(arr, arr->size - 1);
+    assert(removed && arr->size == 8 && stringEquals(arrayGet(arr, 7), "7"));
+    removed = arraySwapRemoveAt(arr, 8) || arraySwapRemoveAt(arr, -1);
+    assert(!removed);
+    arrayRelease(&arr);
+
+    // test the range remotion
+    arr = arrayFill(10);
+    removed = arrayRemoveRange(arr, 2, 3);
+    assert(removed && arr->size == 7 && stringEquals(arrayGet(arr, 1), "1"));
+    assert(stringEquals(arrayGet(arr, 2), "5"));
+    removed = arrayRemoveRange(arr, 5, 2);
+    assert(removed && arr->size == 5);
+    removed = arrayRemoveRange(arr, 0, 0);
+    assert(removed && arr->size == 5);
+    removed = arrayRemoveRange(arr, 3, 3) || arrayRemoveRange(arr, -1, 1);
+    assert(!removed);
+    assert(stringEquals(arrayGet(arr, 4), "7"));
+    arrayRelease(&arr);
+
+    // test the remotion by predicate
+    arr = arrayFill(NUM_OF_ELEMENTS);
+    int divisor = 3;
+    int numOfRemoved = arrayRemoveIf(arr, isMultiple, &divisor);
+    printf("Removed = %d, size = %d\n", numOfRemoved, arr->size);
+    assert(numOfRemoved == (NUM_OF_ELEMENTS + 2) / 3);
+    assert(arr->size == NUM_OF_ELEMENTS - numOfRemoved);
+    for (int i = 0; i < arr->size; i++) {
+        int n = atoi(arrayGet(arr, i));
+        assert(n % 3 != 0 && (i == 0 || atoi(arrayGet(arr, i - 1)) < n));
+    }
+
+    // test the clear and the release of a large array
+    int capacity = arr->capacity;
+    arrayClear(arr);
+    assert(arr->size == 0 && arr->capacity == capacity);
+    arrayAdd(arr, stringNew("last"));
+    arrayRelease(&arr);
+    arr = arrayFill(NUM_OF_ELEMENTS);
+    arrayRelease(&arr);
+    assert(!arr);
+}
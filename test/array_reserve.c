@@ -0,0 +1,67 @@
+#include "../ulib.h"
+
+#define NUM_OF_ELEMENTS 100000
+
+int main()
+{
+    Array *arr = arrayNew(NULL);
+    int numOfReallocs = 0, capacity = arr->capacity;
+    bool res;
+
+    // test the geometric growth
+    for (long i = 0; i < NUM_OF_ELEMENTS; i++) {
+        res = arrayAdd(arr, (void *)i);
+        assert(res);
+        if (arr->capacity != capacity) {
+            assert(arr->capacity == capacity * 2);
+            capacity = arr->capacity;
+            numOfReallocs++;
+        }
+    }
+    printf("Size = %d, capacity = %d, reallocations = %d\n", arr->size, arr->capacity,
+           numOfReallocs);
+    assert(arr->size == NUM_OF_ELEMENTS && numOfReallocs <= 17);
+    for (long i = 0; i < NUM_OF_ELEMENTS; i++)
+        assert(arrayGet(arr, i) == (void *)i);
+
+    // test the insertion
+    res = arrayInsertAt(arr, 0, (void *)-1L);
+    assert(res);
+    res = arrayInsertAt(arr, 1000, (void *)-2L);
+    assert(res);
+    res = arrayInsertAt(arr, arr->size + 1, NULL);
+    assert(!res);
+    assert(arrayGet(arr, 0) == (void *)-1L && arrayGet(arr, 1) == (void *)0L);
+    assert(arrayGet(arr, 1000) == (void *)-2L && arrayGet(arr, 1001) == (void *)999L);
+    assert(arrayGet(arr, arr->size - 1) == (void *)(NUM_OF_ELEMENTS - 1L));
+
+    // test the shrink and the reserve
+    res = arrayShrinkToFit(arr);
+    assert(res && arr->capacity == arr->size);
+    for (int i = 0; i < NUM_OF_ELEMENTS; i++)
+        arrayRemoveAt(arr, arr->size - 1);
+    res = arrayShrinkToFit(arr);
+    assert(arr->size == 2 && res && arr->capacity == 2);
+    res = arrayReserve(arr, 1000);
+    assert(res && arr->capacity == 1000);
+    res = arrayReserve(arr, 10);
+    assert(res && arr->capacity == 1000);
+    for (long i = 0; i < 998; i++)
+        arrayAdd(arr, (void *)i);
+    assert(arr->capacity == 1000);
+    res = arrayReserve(NULL, 10);
+    assert(!res);
+    res = arrayShrinkToFit(NULL);
+    assert(!res);
+    arrayRelease(&arr);
+
+    // test an array with amount
+    arr = arrayNewWithAmount(3, objectRelease);
+    assert(arr->capacity == 3);
+    arraySet(arr, stringNew("Elem1"), 0);
+    arraySet(arr, stringNew("Elem2"), 1);
+    arraySet(arr, stringNew("Elem3"), 2);
+    arrayAdd(arr, stringNew("Elem4"));
+    assert(arr->capacity == 6 && stringEquals(arrayGet(arr, 3), "Elem4"));
+    arrayRelease(&arr);
+}
@@ -0,0 +1,105 @@
+#include "../ulib.h"
+
+#define NUM_OF_ELEMENTS 20000
+
+typedef struct {
+    int key;
+    int seq;
+} Record;
+
+static int compareLong(const void *element1, const void *element2)
+{
+    long n1 = (long)element1, n2 = (long)element2;
+    return (n1 > n2) - (n1 < n2);
+}
+
+static int compareRecord(const void *element1, const void *element2)
+{
+    return ((const Record *)element1)->key - ((const Record *)element2)->key;
+}
+
+int main()
+{
+    Array *arr = arrayNew(NULL);
+    bool sorted;
+    srand(23);
+
+    // test random, sorted, reversed and equal elements
+    for (int kind = 0; kind < 4; kind++) {
+        for (long i = 0; i < NUM_OF_ELEMENTS; i++) {
+            long n = kind == 0 ? rand() % 1000 : kind == 1 ? i : kind == 2 ? -i : 7;
+            arrayAdd(arr, (void *)n);
+        }
+        sorted = arraySort(arr, compareLong);
+        assert(sorted);
+        for (int i = 1; i < arr->size; i++)
+            assert((long)arrayGet(arr, i - 1) <= (long)arrayGet(arr, i));
+        for (int i = 0; i < arr->size; i += 97) {
+            int idx = arrayBinarySearch(arr, arrayGet(arr, i), compareLong);
+            assert(idx >= 0 && idx <= i && arrayGet(arr, idx) == arrayGet(arr, i));
+            assert(idx == 0 || arrayGet(arr, idx - 1) != arrayGet(arr, i));
+        }
+        while (arr->size > 0)
+            arrayRemoveAt(arr, arr->size - 1);
+    }
+    sorted = arraySort(arr, compareLong);
+    assert(sorted && arrayBinarySearch(arr, (void *)1L, compareLong) == -1);
+
+    // test the sorted insertion
+    for (long i = 0; i < 1000; i++) {
+        int inserted = arrayInsertSorted(arr, (void *)(long)(rand() % 100), compareLong);
+        assert(inserted >= 0);
+    }
+    for (int i = 1; i < arr->size; i++)
+        assert((long)arrayGet(arr, i - 1) <= (long)arrayGet(arr, i));
+    assert(arrayBinarySearch(arr, (void *)1000L, compareLong) == -1);
+    arrayRelease(&arr);
+
+    // test the stable sort
+    Record *records = malloc(NUM_OF_ELEMENTS * sizeof(Record));
+    arr = arrayNew(NULL);
+    for (int i = 0; i < NUM_OF_ELEMENTS; i++) {
+        records[i].key = rand() % 50;
+        records[i].seq = i;
+        arrayAdd(arr, &records[i]);
+    }
+    sorted = arrayStableSort(arr, compareRecord);
+    assert(sorted);
+    for (int i = 1; i < arr->size; i++) {
+        Record *record1 = arrayGet(arr, i - 1), *record2 = arrayGet(arr, i);
+        assert(record1->key < record2->key ||
+               (record1->key == record2->key && record1->seq < record2->seq));
+    }
+    Record record = { .key = 25, .seq = NUM_OF_ELEMENTS };
+    int idx = arrayInsertSorted(arr, &record, compareRecord);
+    assert(idx > 0 && ((Record *)arrayGet(arr, idx - 1))->key == 25);
+    assert(((Record *)arrayGet(arr, idx + 1))->key == 26);
+    arrayRelease(&arr);
+    objectRelease(&records);
+
+    // test the strings
+    arr = arrayNew(objectRelease);
+    for (int i = 0; i < NUM_OF_ELEMENTS; i++) {
+        char str[40];
+        snprintf(str, sizeof(str), "unit%d%s", rand() % 5000, i % 2 ? ".service" : "");
+        arrayAdd(arr, stringNew(str));
+    }
+    arrayAdd(arr, NULL);
+    arrayAdd(arr, stringNew(""));
+    sorted = arraySortStr(arr);
+    assert(sorted);
+    assert(arrayGet(arr, 0) == NULL && stringEquals(arrayGet(arr, 1), ""));
+    for (int i = 2; i < arr->size; i++)
+        assert(strcmp(arrayGet(arr, i - 1), arrayGet(arr, i)) <= 0);
+    for (int i = 1; i < arr->size; i += 101) {
+        idx = arrayBinarySearchStr(arr, arrayGet(arr, i));
+        assert(idx >= 0 && stringEquals(arrayGet(arr, idx), arrayGet(arr, i)));
+    }
+    assert(arrayBinarySearchStr(arr, "zzz") == -1);
+    idx = arrayInsertSortedStr(arr, stringNew("unit2500.socket"));
+    printf("Inserted at %d of %d\n", idx, arr->size);
+    assert(strcmp(arrayGet(arr, idx - 1), "unit2500.socket") <= 0);
+    assert(strcmp(arrayGet(arr, idx + 1), "unit2500.socket") > 0);
+    assert(arrayBinarySearchStr(arr, "unit2500.socket") == idx);
+    arrayRelease(&arr);
+}
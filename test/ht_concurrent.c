@@ -0,0 +1,122 @@
+#include "../uhashtable/uhashtable.h"
+
+#define NUM_OF_THREADS 8
+#define NUM_OF_KEYS 20000
+
+static HtConcurrent *htConcurrent = NULL;
+static int values[NUM_OF_KEYS];
+
+static void *writer(void *arg)
+{
+    int id = *(int *)arg;
+    char key[20];
+    // every thread adds its own keys
+    for (int i = id; i < NUM_OF_KEYS; i += NUM_OF_THREADS) {
+        snprintf(key, sizeof(key), "key%d", i);
+        bool added = htConcurrentAdd(htConcurrent, key, &values[i]);
+        assert(added);
+    }
+
+    return NULL;
+}
+
+static void *reader(void *arg)
+{
+    int *found = arg;
+    char key[20];
+    for (int i = 0; i < NUM_OF_KEYS; i++) {
+        snprintf(key, sizeof(key), "key%d", i);
+        if (htConcurrentGet(htConcurrent, key) == &values[i])
+            (*found)++;
+    }
+
+    return NULL;
+}
+
+static void *getOrAdder(void *arg)
+{
+    int *added = arg;
+    char key[20];
+    // all the threads try to add the same keys
+    for (int i = 0; i < NUM_OF_KEYS; i++) {
+        bool isAdded = false;
+        snprintf(key, sizeof(key), "new%d", i);
+        void *value = htConcurrentGetOrAdd(htConcurrent, key, &values[i], &isAdded);
+        assert(value == &values[i]);
+        if (isAdded)
+            (*added)++;
+    }
+
+    return NULL;
+}
+
+int main()
+{
+    pthread_t threads[NUM_OF_THREADS];
+    int args[NUM_OF_THREADS];
+    HtType types[2] = { HT_CHAINED, HT_FLAT };
+
+    for (int t = 0; t < 2; t++) {
+        htConcurrent = htConcurrentNew(types[t], 12, 16, NULL);
+        assert(htConcurrent->numOfShards == 16);
+
+        // test concurrent additions
+        for (int i = 0; i < NUM_OF_THREADS; i++) {
+            args[i] = i;
+            pthread_create(&threads[i], NULL, writer, &args[i]);
+        }
+        for (int i = 0; i < NUM_OF_THREADS; i++)
+            pthread_join(threads[i], NULL);
+        assert(htConcurrentNumOfItems(htConcurrent) == NUM_OF_KEYS);
+
+        // test concurrent lookups while the keys are removed and set
+        for (int i = 0; i < NUM_OF_THREADS; i++) {
+            args[i] = 0;
+            pthread_create(&threads[i], NULL, reader, &args[i]);
+        }
+        bool removed = htConcurrentRemove(htConcurrent, "key0");
+        assert(removed);
+        removed = htConcurrentRemove(htConcurrent, "key0");
+        assert(!removed);
+        bool set = htConcurrentSet(htConcurrent, "key1", &values[1]);
+        assert(set);
+        for (int i = 0; i < NUM_OF_THREADS; i++) {
+            pthread_join(threads[i], NULL);
+            assert(args[i] >= NUM_OF_KEYS - 1);
+        }
+        assert(!htConcurrentGet(htConcurrent, "key0"));
+        assert(htConcurrentGet(htConcurrent, "key1") == &values[1]);
+        assert(htConcurrentNumOfItems(htConcurrent) == NUM_OF_KEYS - 1);
+
+        // test the atomic get or add
+        for (int i = 0; i < NUM_OF_THREADS; i++) {
+            args[i] = 0;
+            pthread_create(&threads[i], NULL, getOrAdder, &args[i]);
+        }
+        int added = 0;
+        for (int i = 0; i < NUM_OF_THREADS; i++) {
+            pthread_join(threads[i], NULL);
+            added += args[i];
+        }
+        printf("Type %d: get or add added = %d\n", types[t], added);
+        assert(added == NUM_OF_KEYS);
+        assert(htConcurrentNumOfItems(htConcurrent) == NUM_OF_KEYS * 2 - 1);
+
+        htConcurrentRelease(&htConcurrent);
+        assert(!htConcurrent);
+    }
+
+    // test the get or add of a plain hash table
+    Ht *ht = htNew(7, NULL);
+    bool added = false;
+    void *value = htGetOrAdd(ht, "Description", "1", &added);
+    assert(value && added);
+    value = htGetOrAdd(ht, "Description", "2", &added);
+    assert(stringEquals(value, "1") && !added);
+    value = htGetOrAddN(ht, "Description=Network", 11, "3", NULL);
+    assert(stringEquals(value, "1"));
+    value = htGetOrAdd(ht, "", "4", &added);
+    assert(!value && !added);
+    assert(ht->numOfItems == 1);
+    htRelease(&ht);
+}
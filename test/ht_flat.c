@@ -0,0 +1,75 @@
+#include "../uhashtable/uhashtable.h"
+
+int main()
+{
+    int capacity = 5;
+    Ht *ht = htNewFlat(capacity, objectRelease);
+    printf("Initial capacity = %d (requested %d)\n", ht->capacity, capacity);
+
+    // test add and resize
+    for (int i = 0; i < 1500; i++) {
+        char key[50] = { 0 };
+        char value[50] = { 0 };
+        snprintf(key, sizeof(key), "Domenico%d", i);
+        snprintf(value, sizeof(value), "Panella%d", i);
+        htAdd(ht, key, stringNew(value));
+    }
+    // duplicate key
+    char *dup = stringNew("Duplicate");
+    if (!htAdd(ht, "Domenico10", dup)) {
+        printf("Domenico10 key is duplicate!\n");
+        objectRelease(&dup);
+    }
+
+    // test get
+    char *value = htGet(ht, "Domenico608");
+    if (value)
+        printf("Domenico608 key is present! Value = %s\n", value);
+    assert(value && stringEquals(value, "Panella608"));
+    value = htGet(ht, "Ciccio");
+    if (!value)
+        printf("Ciccio key is not present!\n");
+    assert(!value);
+
+    // test set
+    htSet(ht, "Domenico9", stringNew("PanellaReplaced"));
+    assert(stringEquals(htGet(ht, "Domenico9"), "PanellaReplaced"));
+
+    // test remove and resize
+    for (int i = 0; i < 1485; i++) {
+        char key[50] = { 0 };
+        snprintf(key, sizeof(key), "Domenico%d", i);
+        bool removed = htRemove(ht, key);
+        assert(removed);
+    }
+    bool removed = htRemove(ht, "Domenico0");
+    assert(!removed);
+
+    /* Set debug data */
+    htSetDebugData(ht);
+
+    printf("\n\nIterator\n");
+    int count = 0;
+    HtIterator *htIter = htGetIterator(ht);
+    if (htIter) {
+        while ((value = htGetNext(htIter))) {
+            printf("Slot idx = %d, value = %s\n", htIter->hashIdx, value);
+            count++;
+        }
+    }
+    objectRelease(&htIter);
+    assert(count == ht->numOfItems);
+    for (int i = 1485; i < 1500; i++) {
+        char key[50] = { 0 };
+        snprintf(key, sizeof(key), "Domenico%d", i);
+        assert(htGet(ht, key));
+    }
+
+    printf("\nSUMMARY\n");
+    printf("Capacity = %d\n", ht->capacity);
+    printf("Elements = %d\n", ht->numOfItems);
+    printf("Max collisions for entry = %d\n", ht->maxCollisionsForEntry);
+    printf("Total collisions = %d\n", ht->totCollisions);
+
+    htRelease(&ht);
+}
@@ -0,0 +1,97 @@
+#include "../uhashtable/uhashtable.h"
+
+#define NUM_OF_KEYS 1000
+
+int main()
+{
+    HtType types[2] = { HT_CHAINED, HT_FLAT };
+
+    for (int t = 0; t < 2; t++) {
+        Ht *ht = htNewWithPolicy(types[t], 8, NULL, NULL);
+        long sum = 0;
+        for (long i = 1; i <= NUM_OF_KEYS; i++) {
+            char key[40];
+            snprintf(key, sizeof(key), "unit%ld.service", i);
+            bool added = htAdd(ht, key, (void *)i);
+            assert(added);
+            sum += i;
+        }
+
+        // test the iterator on the stack
+        HtIterator htIter;
+        const char *key = NULL;
+        void *value = NULL;
+        long total = 0;
+        htIterInit(ht, &htIter);
+        while (htIterNext(&htIter, &key, &value)) {
+            assert(atol(key + 4) == (long)value);
+            total += (long)value;
+        }
+        assert(total == sum);
+
+        // test the foreach macro
+        total = 0;
+        HT_FOREACH(ht, key, value)
+        {
+            assert(atol(key + 4) == (long)value);
+            total += (long)value;
+        }
+        assert(total == sum);
+
+        // test the break and the nested iterations
+        int count = 0;
+        HT_FOREACH(ht, key, value)
+        {
+            const char *key2 = NULL;
+            void *value2 = NULL;
+            HT_FOREACH(ht, key2, value2)
+            {
+                count++;
+            }
+            if ((long)value == NUM_OF_KEYS / 2)
+                break;
+        }
+        assert(count > 0 && count % NUM_OF_KEYS == 0);
+
+        // test the remotion into the foreach macro
+        HT_FOREACH(ht, key, value)
+        {
+            if ((long)value % 2 == 0) {
+                bool removed = htIterRemove(&htForeachIter);
+                assert(removed);
+            }
+        }
+        printf("Type %d: items = %d, capacity = %d\n", types[t], ht->numOfItems, ht->capacity);
+        assert(ht->numOfItems == NUM_OF_KEYS / 2);
+        total = 0;
+        HT_FOREACH(ht, key, value)
+        {
+            total += (long)value;
+        }
+        assert(total == (long)NUM_OF_KEYS * NUM_OF_KEYS / 4);
+
+        // test an empty hash table
+        Ht *htEmpty = htNewWithPolicy(types[t], 8, NULL, NULL);
+        HT_FOREACH(htEmpty, key, value)
+        {
+            assert(false);
+        }
+        htRelease(&htEmpty);
+        htRelease(&ht);
+    }
+
+    // test a NULL hash table
+    Ht *htNull = NULL;
+    const char *key = NULL;
+    void *value = NULL;
+    HT_FOREACH(htNull, key, value)
+    {
+        assert(false);
+    }
+    HtIterator htIter = { 0 };
+    htIterInit(htNull, &htIter);
+    bool found = htIterNext(&htIter, &key, &value);
+    assert(!found);
+    bool removed = htIterRemove(&htIter);
+    assert(!removed);
+}
@@ -0,0 +1,65 @@
+#include "../uhashtable/uhashtable.h"
+
+#define NUM_OF_KEYS 20000
+
+int main()
+{
+    HtType types[2] = { HT_CHAINED, HT_FLAT };
+    char key[30];
+
+    for (int t = 0; t < 2; t++) {
+        Ht *ht = htNewWithPolicy(types[t], 7, objectRelease, NULL);
+        for (int i = 0; i < NUM_OF_KEYS; i++) {
+            // short and long keys
+            snprintf(key, sizeof(key), i % 2 ? "unit%d.service" : "u%d", i);
+            bool added = htAdd(ht, key, stringNew(key));
+            assert(added);
+        }
+        HtFrozen *htFrozen = htFreeze(&ht);
+        assert(!ht);
+        printf("Type %d: items = %d, buckets = %d\n", types[t], htFrozen->numOfItems,
+               htFrozen->numOfBuckets);
+        assert(htFrozen->numOfItems == NUM_OF_KEYS);
+
+        // test lookups
+        for (int i = 0; i < NUM_OF_KEYS; i++) {
+            snprintf(key, sizeof(key), i % 2 ? "unit%d.service" : "u%d", i);
+            assert(stringEquals(htFrozenGet(htFrozen, key), key));
+            snprintf(key, sizeof(key), i % 2 ? "u%d" : "unit%d.service", i);
+            assert(!htFrozenGet(htFrozen, key));
+        }
+        assert(stringEquals(htFrozenGetN(htFrozen, "u0=value", 2), "u0"));
+        assert(!htFrozenGet(htFrozen, ""));
+        assert(!htFrozenGet(htFrozen, NULL));
+
+        // test the iteration: every item is visited once
+        int count = 0;
+        const char *itemKey = NULL;
+        for (int i = 0; i < htFrozen->numOfItems; i++) {
+            char *value = htFrozenGetAt(htFrozen, i, &itemKey);
+            assert(stringEquals(value, itemKey));
+            count++;
+        }
+        assert(count == NUM_OF_KEYS);
+        assert(!htFrozenGetAt(htFrozen, NUM_OF_KEYS, &itemKey));
+        htFrozenRelease(&htFrozen);
+        assert(!htFrozen);
+    }
+
+    // test small hash tables
+    for (int n = 0; n < 5; n++) {
+        Ht *ht = htNew(7, NULL);
+        for (int i = 0; i < n; i++) {
+            snprintf(key, sizeof(key), "key%d", i);
+            htAdd(ht, key, "value");
+        }
+        HtFrozen *htFrozen = htFreeze(&ht);
+        assert(htFrozen->numOfItems == n);
+        for (int i = 0; i < n; i++) {
+            snprintf(key, sizeof(key), "key%d", i);
+            assert(htFrozenGet(htFrozen, key));
+        }
+        assert(!htFrozenGet(htFrozen, "missing"));
+        htFrozenRelease(&htFrozen);
+    }
+}
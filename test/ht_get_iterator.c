@@ -27,16 +27,16 @@ int main()
     Ht *ht = htNew(capacity, objectRelease);
     printf("Initial capacity = %d\n", capacity);
 
-    Array *htEntries = ht->htEntries;
-    for (int i = 0; i < htEntries->size; i++) {
+    HtEntry *htEntries = ht->htEntries;
+    for (int i = 0; i < ht->capacity; i++) {
         printf("Before Hash %d\n", i);
-        HtEntry *htEntry = arrayGet(htEntries, i);
-        if (htEntry) {
-            Array *htItems = htEntry->htItems;
-            int lenHtItems = htItems->size;
+        HtEntry *htEntry = &htEntries[i];
+        if (htEntry->size > 0) {
+            HtItem *htItems = htEntry->htItems;
+            int lenHtItems = htEntry->size;
             for (int j = 0; j < lenHtItems; j++) {
-                HtItem *htItem = arrayGet(htItems, j);
-                printf("    Key = %s, Value = %s\n", htItem->key, (char *)htItem->value);
+                HtItem *htItem = &htItems[j];
+                printf("    Key = %s, Value = %s\n", htItemKey(htItem), (char *)htItem->value);
             }
         }
     }
@@ -47,22 +47,22 @@ int main()
         char value[50] = { 0 };
         sprintf(key, "Domenico%d", i);
         sprintf(value, "Panella%d", i);
-        htAdd(&ht, key, stringNew(value));
+        htAdd(ht, key, stringNew(value));
     }
 
     /* Set debug data */
     htSetDebugData(ht);
 
     htEntries = ht->htEntries;
-    for (int i = 0; i < htEntries->size; i++) {
+    for (int i = 0; i < ht->capacity; i++) {
         printf("After Hash %d\n", i);
-        HtEntry *htEntry = arrayGet(htEntries, i);
-        if (htEntry) {
-            Array *htItems = htEntry->htItems;
-            int lenHtItems = htItems->size;
+        HtEntry *htEntry = &htEntries[i];
+        if (htEntry->size > 0) {
+            HtItem *htItems = htEntry->htItems;
+            int lenHtItems = htEntry->size;
             for (int j = 0; j < lenHtItems; j++) {
-                HtItem *htItem = arrayGet(htItems, j);
-                printf("    Key = %s, Value = %s\n", htItem->key, (char *)htItem->value);
+                HtItem *htItem = &htItems[j];
+                printf("    Key = %s, Value = %s\n", htItemKey(htItem), (char *)htItem->value);
             }
         }
     }
@@ -88,6 +88,15 @@ int main()
     //        }
     //    }
 
+    printf("\n\nTest modification during the iteration\n");
+    htIteratorReset(ht, htIter);
+    htGetNext(htIter);
+    htAdd(ht, "Ciccio", stringNew("Modification"));
+    if (!htGetNext(htIter) && htIter->version != ht->version)
+        printf("The hash table has been modified!\n");
+    else
+        return 1;
+
     objectRelease(&htIter);
 
     printf("\nSUMMARY\n");
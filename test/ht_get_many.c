@@ -0,0 +1,46 @@
+#include "../uhashtable/uhashtable.h"
+
+#define NUM_OF_KEYS 1000
+
+int main()
+{
+    HtType types[2] = { HT_CHAINED, HT_FLAT };
+    char names[NUM_OF_KEYS * 2][30];
+    const char *keys[NUM_OF_KEYS * 2 + 2];
+    void *values[NUM_OF_KEYS * 2 + 2];
+
+    for (int t = 0; t < 2; t++) {
+        Ht *ht = htNewWithPolicy(types[t], 7, NULL, NULL);
+        for (int i = 0; i < NUM_OF_KEYS; i++) {
+            snprintf(names[i], sizeof(names[i]), "unit%d.service", i);
+            bool added = htAdd(ht, names[i], names[i]);
+            assert(added);
+        }
+        // the even keys exist, the odd ones don't
+        for (int i = 0; i < NUM_OF_KEYS * 2; i++) {
+            if (i % 2 == 0) {
+                keys[i] = names[i / 2];
+            } else {
+                snprintf(names[NUM_OF_KEYS + i / 2], sizeof(names[0]), "missing%d", i);
+                keys[i] = names[NUM_OF_KEYS + i / 2];
+            }
+        }
+        keys[NUM_OF_KEYS * 2] = NULL;
+        keys[NUM_OF_KEYS * 2 + 1] = "";
+
+        int found = htGetMany(ht, keys, NUM_OF_KEYS * 2 + 2, values);
+        printf("Type %d: found = %d\n", types[t], found);
+        assert(found == NUM_OF_KEYS);
+        for (int i = 0; i < NUM_OF_KEYS * 2 + 2; i++)
+            assert(values[i] == (i % 2 == 0 && i < NUM_OF_KEYS * 2 ? keys[i] : NULL));
+
+        // test a lookup of less keys than a batch
+        found = htGetMany(ht, keys, 3, values);
+        assert(found == 2);
+        found = htGetMany(ht, keys, 0, values);
+        assert(found == 0);
+        found = htGetMany(NULL, keys, 3, values);
+        assert(found == 0);
+        htRelease(&ht);
+    }
+}
@@ -0,0 +1,49 @@
+#include "../uhashtable/uhashtable.h"
+
+int main()
+{
+    const char *line = "Description=Network;Requires=udev;After=udev";
+    HtType types[2] = { HT_CHAINED, HT_FLAT };
+
+    for (int t = 0; t < 2; t++) {
+        Ht *ht = htNewWithPolicy(types[t], 7, NULL, NULL);
+        htAdd(ht, "Description", "1");
+        htAdd(ht, "Requires", "2");
+        htAdd(ht, "After", "3");
+
+        // test get from the slices of the line without copying them
+        const char *start = line;
+        while (*start) {
+            const char *end = strchr(start, '=');
+            assert(end);
+            char *value = htGetN(ht, start, end - start);
+            printf("Key = %.*s, Value = %s\n", (int)(end - start), start, value);
+            assert(value);
+            start = strchr(end, ';');
+            if (!start)
+                break;
+            start++;
+        }
+
+        // the prefix of a key is not the key
+        assert(!htGetN(ht, "Description", 4));
+        assert(!htGetN(ht, "Require", 7));
+
+        // test add, set and remove from the slices
+        bool res = htAddN(ht, "Wants=udev", 5, "4");
+        assert(res);
+        res = htAddN(ht, "Wants", 5, "4");
+        assert(!res);
+        assert(stringEquals(htGet(ht, "Wants"), "4"));
+        res = htSetN(ht, "Wants=udev", 5, "5");
+        assert(res);
+        assert(stringEquals(htGetN(ht, "Wants", 5), "5"));
+        res = htRemoveN(ht, "Wants=udev", 5);
+        assert(res);
+        assert(!htGet(ht, "Wants"));
+        res = htAddN(ht, "Wants", 0, "4");
+        assert(!res);
+
+        htRelease(&ht);
+    }
+}
@@ -0,0 +1,127 @@
+#include "../uhashtable/uhashtable.h"
+
+#define NUM_OF_KEYS 20000
+
+int main()
+{
+    HtInt *htInt = htIntNew(8, objectRelease);
+    uint64_t *keys = malloc(NUM_OF_KEYS * sizeof(uint64_t));
+
+    // test sequential pids and random 64 bit keys (0 included)
+    srand(19);
+    for (int i = 0; i < NUM_OF_KEYS; i++) {
+        keys[i] = i < NUM_OF_KEYS / 2 ? (uint64_t)i :
+                                        ((uint64_t)rand() << 33) ^ ((uint64_t)rand() << 2) ^ i;
+        char value[30];
+        snprintf(value, sizeof(value), "%" PRIu64, keys[i]);
+        bool added = htIntAdd(htInt, keys[i], stringNew(value));
+        assert(added);
+    }
+    assert(htInt->numOfItems == NUM_OF_KEYS);
+    bool res = htIntAdd(htInt, 0, NULL);
+    assert(!res);
+    printf("Items = %d, capacity = %d\n", htInt->numOfItems, htInt->capacity);
+    for (int i = 0; i < NUM_OF_KEYS; i++) {
+        char value[30];
+        snprintf(value, sizeof(value), "%" PRIu64, keys[i]);
+        assert(stringEquals(htIntGet(htInt, keys[i]), value));
+    }
+    assert(!htIntGet(htInt, UINT64_MAX));
+
+    // test the iteration
+    HtIntIterator htIntIter;
+    uint64_t key = 0;
+    void *value = NULL;
+    int count = 0;
+    htIntIterInit(htInt, &htIntIter);
+    while (htIntIterNext(&htIntIter, &key, &value)) {
+        assert(strtoull(value, NULL, 10) == key);
+        count++;
+    }
+    assert(count == NUM_OF_KEYS);
+
+    // test get or add, set and remove
+    bool added = true;
+    value = htIntGetOrAdd(htInt, 5, NULL, &added);
+    assert(stringEquals(value, "5") && !added);
+    res = htIntSet(htInt, 5, stringNew("five"));
+    assert(res && stringEquals(htIntGet(htInt, 5), "five"));
+    res = htIntSet(htInt, UINT64_MAX, NULL);
+    assert(!res);
+    for (int i = 0; i < NUM_OF_KEYS; i += 2) {
+        res = htIntRemove(htInt, keys[i]);
+        assert(res);
+    }
+    res = htIntRemove(htInt, keys[0]);
+    assert(!res);
+    assert(htInt->numOfItems == NUM_OF_KEYS / 2);
+    for (int i = 0; i < NUM_OF_KEYS; i++)
+        assert((htIntGet(htInt, keys[i]) != NULL) == (i % 2 == 1));
+    for (int i = 1; i < NUM_OF_KEYS; i += 2) {
+        res = htIntRemove(htInt, keys[i]);
+        assert(res);
+    }
+    printf("Items = %d, capacity = %d\n", htInt->numOfItems, htInt->capacity);
+    assert(htInt->numOfItems == 0 && htInt->capacity == 8);
+    value = htIntGetOrAdd(htInt, 7, stringNew("7"), &added);
+    assert(value && added);
+    htIntRelease(&htInt);
+    assert(!htInt);
+    objectRelease(&keys);
+
+    // test the pointer keys
+    HtPtr *htPtr = htPtrNew(16, NULL);
+    int objects[100];
+    for (int i = 0; i < 100; i++) {
+        res = htPtrAdd(htPtr, &objects[i], (void *)(long)(i + 1));
+        assert(res);
+    }
+    res = htPtrAdd(htPtr, &objects[0], NULL);
+    assert(!res);
+    assert(!htPtrGet(htPtr, NULL));
+    for (int i = 0; i < 100; i++)
+        assert(htPtrGet(htPtr, &objects[i]) == (void *)(long)(i + 1));
+    const void *ptr = NULL;
+    count = 0;
+    htPtrIterInit(htPtr, &htIntIter);
+    while (htPtrIterNext(&htIntIter, &ptr, &value)) {
+        assert((const int *)ptr - objects + 1 == (long)value);
+        count++;
+    }
+    assert(count == 100);
+    res = htPtrRemove(htPtr, &objects[50]);
+    assert(res && !htPtrGet(htPtr, &objects[50]));
+    res = htPtrSet(htPtr, &objects[51], NULL);
+    assert(res && !htPtrGet(htPtr, &objects[51]));
+    value = htPtrGetOrAdd(htPtr, &objects[51], (void *)1L, &added);
+    assert(!value && !added);
+    htPtrRelease(&htPtr);
+
+    // test the resize policy: no shrink and a minimum capacity
+    HtPolicy policy = { .growLoadFactor = 0.5, .shrinkLoadFactor = 0.1, .minCapacity = 32,
+                        .shrinkDisabled = true };
+    htInt = htIntNewWithPolicy(4, NULL, &policy);
+    assert(htInt->capacity == 32);
+    for (uint64_t i = 0; i < 16; i++)
+        htIntAdd(htInt, i, NULL);
+    assert(htInt->capacity == 64);
+    for (uint64_t i = 0; i < 16; i++)
+        htIntRemove(htInt, i);
+    assert(htInt->numOfItems == 0 && htInt->capacity == 64);
+    htIntRelease(&htInt);
+
+    // test an invalid policy: an open addressing table needs an empty slot
+    HtPolicy full = { .growLoadFactor = 1, .shrinkDisabled = true };
+    htInt = htIntNewWithPolicy(4, NULL, &full);
+    assert(htInt == NULL);
+    htPtr = htPtrNewWithPolicy(4, NULL, &full);
+    assert(htPtr == NULL);
+
+    // test a NULL hash table
+    HtIntIterator htNullIter = { 0 };
+    htIntIterInit(NULL, &htNullIter);
+    bool found = htIntIterNext(&htNullIter, &key, &value);
+    assert(!found);
+    found = htPtrIterNext(&htNullIter, &ptr, &value);
+    assert(!found);
+}
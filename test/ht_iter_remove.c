@@ -0,0 +1,92 @@
+#include "../uhashtable/uhashtable.h"
+
+#define NUM_OF_KEYS 4000
+
+int main()
+{
+    HtType types[2] = { HT_CHAINED, HT_FLAT };
+
+    for (int t = 0; t < 2; t++) {
+        // test with and without an incremental rehashing in progress
+        for (int rehashStep = 0; rehashStep < 2; rehashStep++) {
+            Ht *ht = htNewWithPolicy(types[t], 16, objectRelease, NULL);
+            htSetRehashStep(ht, rehashStep);
+            for (int i = 0; i < NUM_OF_KEYS; i++) {
+                char key[30];
+                snprintf(key, sizeof(key), "unit%d.service", i);
+                bool added = htAdd(ht, key, stringNew(key));
+                assert(added);
+            }
+            int capacity = ht->capacity;
+            // the last growth of a chained hash table is still being rehashed
+            assert(types[t] == HT_FLAT || (ht->htOldEntries != NULL) == (rehashStep == 1));
+
+            // remove the odd keys during the iteration, every item must be visited once
+            char *visited = calloc(NUM_OF_KEYS, sizeof(char));
+            HtIterator *htIter = htGetIterator(ht);
+            const char *key = NULL;
+            void *value = NULL;
+            bool removed = htIterRemove(htIter);
+            assert(!removed);
+            while (htIterNext(htIter, &key, &value)) {
+                assert(stringEquals(key, value));
+                int i = atoi(key + 4);
+                assert(!visited[i]);
+                visited[i] = 1;
+                if (i % 2 == 1) {
+                    removed = htIterRemove(htIter);
+                    assert(removed);
+                    removed = htIterRemove(htIter);
+                    assert(!removed);
+                    // the hash table is not shrunk during the iteration
+                    assert(ht->capacity == capacity);
+                }
+            }
+            for (int i = 0; i < NUM_OF_KEYS; i++)
+                assert(visited[i]);
+            assert(ht->numOfItems == NUM_OF_KEYS / 2);
+            for (int i = 0; i < NUM_OF_KEYS; i++) {
+                char key[30];
+                snprintf(key, sizeof(key), "unit%d.service", i);
+                assert((htGet(ht, key) != NULL) == (i % 2 == 0));
+            }
+
+            // remove almost all the keys, the shrink is performed at the end of the iteration
+            htIteratorReset(ht, htIter);
+            int count = 0;
+            while (htIterNext(htIter, &key, NULL)) {
+                if (atoi(key + 4) >= 20) {
+                    removed = htIterRemove(htIter);
+                    assert(removed);
+                }
+                count++;
+            }
+            assert(count == NUM_OF_KEYS / 2);
+            printf("Type %d, rehash step %d: capacity %d -> %d, items = %d\n", types[t],
+                   rehashStep, capacity, ht->capacity, ht->numOfItems);
+            assert(ht->numOfItems == 10);
+            assert(ht->capacity < capacity);
+            htIteratorReset(ht, htIter);
+            count = 0;
+            while (htGetNext(htIter))
+                count++;
+            assert(count == 10);
+
+            // another iterator is invalidated by the removal
+            HtIterator *htIter2 = htGetIterator(ht);
+            htIteratorReset(ht, htIter);
+            bool found = htIterNext(htIter, NULL, NULL);
+            removed = htIterRemove(htIter);
+            assert(found && removed);
+            found = htIterNext(htIter2, NULL, NULL);
+            assert(!found);
+            found = htIterNext(htIter, NULL, NULL);
+            assert(found);
+
+            objectRelease(&htIter2);
+            objectRelease(&htIter);
+            objectRelease(&visited);
+            htRelease(&ht);
+        }
+    }
+}
@@ -0,0 +1,100 @@
+#include "../uhashtable/uhashtable.h"
+
+static const char *htFlatKey(Ht *ht, const char *key)
+{
+    HtItem *htSlots = ht->htSlots;
+    for (int i = 0; i < ht->capacity; i++) {
+        if (htSlots[i].keyLen && stringEquals(htItemKey(&htSlots[i]), key))
+            return htItemKey(&htSlots[i]);
+    }
+    return NULL;
+}
+
+int main()
+{
+    HtType types[2] = { HT_CHAINED, HT_FLAT };
+
+    for (int t = 0; t < 2; t++) {
+        // test borrowed keys
+        char buffer[] = "Description=Network;Requires=udev";
+        Ht *ht = htNewWithPolicy(types[t], 7, NULL, NULL);
+        bool res = htSetKeyMode(ht, HT_KEY_BORROW);
+        assert(res);
+        res = htAddN(ht, buffer, 11, "1");
+        assert(res);
+        res = htAddN(ht, buffer + 20, 8, "2");
+        assert(res);
+        res = htSetKeyMode(ht, HT_KEY_COPY);
+        assert(!res);
+        for (int i = 0; i < 100; i++) {
+            char key[16];
+            snprintf(key, sizeof(key), "key%d", i);
+            assert(!htGet(ht, key));
+        }
+        assert(stringEquals(htGet(ht, "Description"), "1"));
+        assert(stringEquals(htGet(ht, "Requires"), "2"));
+        res = htRemove(ht, "Description");
+        assert(res && !htGet(ht, "Description"));
+        res = htRemove(ht, "Requires");
+        assert(res);
+        res = htSetKeyMode(ht, HT_KEY_COPY);
+        assert(res);
+        htRelease(&ht);
+        printf("Borrowed keys: type %d ok\n", types[t]);
+
+        // test interned keys shared by two hash tables
+        Ht *ht1 = htNewWithPolicy(types[t], 7, NULL, NULL);
+        Ht *ht2 = htNewWithPolicy(types[t], 7, NULL, NULL);
+        res = htSetKeyMode(ht1, HT_KEY_INTERN) && htSetKeyMode(ht2, HT_KEY_INTERN);
+        assert(res);
+        for (int i = 0; i < 1000; i++) {
+            char key[16];
+            snprintf(key, sizeof(key), "key%d", i);
+            res = htAdd(ht1, key, "1");
+            assert(res);
+            if (i % 2 == 0) {
+                res = htAdd(ht2, key, "2");
+                assert(res);
+            }
+        }
+        for (int i = 0; i < 1000; i++) {
+            char key[16];
+            snprintf(key, sizeof(key), "key%d", i);
+            assert(stringEquals(htGet(ht1, key), "1"));
+            assert(i % 2 == 0 ? stringEquals(htGet(ht2, key), "2") : !htGet(ht2, key));
+        }
+        if (types[t] == HT_FLAT) {
+            assert(htFlatKey(ht1, "key10") == htFlatKey(ht2, "key10"));
+            assert(htFlatKey(ht1, "key11") && !htFlatKey(ht2, "key11"));
+        }
+        // the interned key must survive the removal from the first hash table
+        res = htRemove(ht1, "key10");
+        assert(res && stringEquals(htGet(ht2, "key10"), "2"));
+        res = htSet(ht2, "key10", "3");
+        assert(res && stringEquals(htGet(ht2, "key10"), "3"));
+        htRelease(&ht1);
+        assert(stringEquals(htGet(ht2, "key998"), "2"));
+        htRelease(&ht2);
+        printf("Interned keys: type %d ok\n", types[t]);
+
+        // test copied keys around the inline size while the hash table grows and shrinks
+        ht = htNewWithPolicy(types[t], 7, NULL, NULL);
+        char keys[HT_KEY_INLINE_SIZE * 2][HT_KEY_INLINE_SIZE * 2 + 1];
+        for (int len = 1; len <= HT_KEY_INLINE_SIZE * 2; len++) {
+            memset(keys[len - 1], 'a' + len % 26, len);
+            keys[len - 1][len] = '\0';
+            res = htAdd(ht, keys[len - 1], keys[len - 1]);
+            assert(res);
+        }
+        for (int len = 1; len <= HT_KEY_INLINE_SIZE * 2; len++)
+            assert(htGet(ht, keys[len - 1]) == keys[len - 1]);
+        for (int len = 1; len <= HT_KEY_INLINE_SIZE * 2; len += 2) {
+            res = htRemove(ht, keys[len - 1]);
+            assert(res);
+        }
+        for (int len = 1; len <= HT_KEY_INLINE_SIZE * 2; len++)
+            assert(htGet(ht, keys[len - 1]) == (len % 2 ? NULL : keys[len - 1]));
+        htRelease(&ht);
+        printf("Inline keys: type %d ok\n", types[t]);
+    }
+}
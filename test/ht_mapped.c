@@ -0,0 +1,163 @@
+#include "../uhashtable/uhashtable.h"
+#include <unistd.h>
+
+#define NUM_OF_KEYS 10000
+
+typedef struct {
+    int id;
+    double weight;
+} Unit;
+
+static size_t unitSize(const void *value)
+{
+    (void)value;
+    return sizeof(Unit);
+}
+
+static void writeUnits(const char *path, Unit *units)
+{
+    Ht *ht = htNew(7, NULL);
+    htAdd(ht, "a.service", &units[0]);
+    htAdd(ht, "b.service", &units[1]);
+    htAdd(ht, "c.service", &units[2]);
+    HtFrozen *htFrozen = htFreeze(&ht);
+    bool written = htFrozenWrite(htFrozen, path, unitSize);
+    assert(written);
+    htFrozenRelease(&htFrozen);
+}
+
+static bool openCorrupted(const char *path, uint64_t offset, const void *data, size_t size)
+{
+    FILE *file = fopen(path, "r+b");
+    assert(file);
+    fseek(file, offset, SEEK_SET);
+    fwrite(data, 1, size, file);
+    fclose(file);
+    HtMapped *htMapped = htMappedOpen(path);
+    bool valid = htMapped != NULL;
+    htMappedClose(&htMapped);
+
+    return valid;
+}
+
+int main()
+{
+    char path[] = "/tmp/ht_mapped_XXXXXX";
+    char key[30];
+    int fd = mkstemp(path);
+    assert(fd != -1);
+    close(fd);
+
+    // test string values
+    Ht *ht = htNewFlat(7, objectRelease);
+    for (int i = 0; i < NUM_OF_KEYS; i++) {
+        snprintf(key, sizeof(key), "unit%d.service", i);
+        bool added = htAdd(ht, key, i == 7 ? NULL : stringNew(key));
+        assert(added);
+    }
+    HtFrozen *htFrozen = htFreeze(&ht);
+    bool written = htFrozenWrite(htFrozen, path, NULL);
+    assert(written);
+    htFrozenRelease(&htFrozen);
+
+    HtMapped *htMapped = htMappedOpen(path);
+    assert(htMapped);
+    printf("Items = %d, file size = %zu\n", htMapped->numOfItems, htMapped->mapSize);
+    assert(htMapped->numOfItems == NUM_OF_KEYS);
+    size_t size = 0;
+    for (int i = 0; i < NUM_OF_KEYS; i++) {
+        snprintf(key, sizeof(key), "unit%d.service", i);
+        const char *value = htMappedGet(htMapped, key, &size);
+        assert(value && size == (i == 7 ? 1 : strlen(key) + 1));
+        assert(stringEquals(value, i == 7 ? "" : key));
+        // the values are aligned
+        assert(((uintptr_t)value) % 8 == 0);
+    }
+    const char *value = htMappedGet(htMapped, "missing", &size);
+    assert(!value);
+    value = htMappedGetN(htMapped, "unit1.service=x", 13, NULL);
+    assert(value);
+    const char *itemKey = NULL;
+    for (int i = 0; i < htMapped->numOfItems; i++) {
+        const char *value = htMappedGetAt(htMapped, i, &itemKey, NULL);
+        assert(stringEquals(value, itemKey) || stringEquals(itemKey, "unit7.service"));
+    }
+    htMappedClose(&htMapped);
+    assert(!htMapped);
+
+    // test blob values
+    Unit units[3] = { { 1, 0.5 }, { 2, 1.5 }, { 3, 2.5 } };
+    writeUnits(path, units);
+    htMapped = htMappedOpen(path);
+    const Unit *unit = htMappedGet(htMapped, "b.service", &size);
+    assert(unit && size == sizeof(Unit) && unit->id == 2 && unit->weight == 1.5);
+    htMappedClose(&htMapped);
+
+    // test a NULL blob value, it is written as zeros
+    ht = htNew(7, NULL);
+    htAdd(ht, "a.service", &units[0]);
+    htAdd(ht, "null.service", NULL);
+    htFrozen = htFreeze(&ht);
+    written = htFrozenWrite(htFrozen, path, unitSize);
+    assert(written);
+    htFrozenRelease(&htFrozen);
+    htMapped = htMappedOpen(path);
+    unit = htMappedGet(htMapped, "null.service", &size);
+    assert(unit && size == sizeof(Unit) && unit->id == 0 && unit->weight == 0);
+    htMappedClose(&htMapped);
+
+    // test an empty hash table
+    ht = htNew(7, NULL);
+    htFrozen = htFreeze(&ht);
+    written = htFrozenWrite(htFrozen, path, NULL);
+    assert(written);
+    htFrozenRelease(&htFrozen);
+    htMapped = htMappedOpen(path);
+    assert(htMapped && htMapped->numOfItems == 0);
+    value = htMappedGet(htMapped, "a.service", NULL);
+    assert(!value);
+    htMappedClose(&htMapped);
+
+    // test corrupted offset tables
+    writeUnits(path, units);
+    htMapped = htMappedOpen(path);
+    assert(htMapped);
+    HtSnapshotHeader header = *(const HtSnapshotHeader *)htMapped->map;
+    htMappedClose(&htMapped);
+    uint64_t valueOffset = 1 << 20;
+    bool valid = openCorrupted(path, header.valueOffsetsOffset, &valueOffset, sizeof(uint64_t));
+    assert(!valid);
+    writeUnits(path, units);
+    valueOffset = 4;
+    valid = openCorrupted(path, header.valueOffsetsOffset, &valueOffset, sizeof(uint64_t));
+    assert(!valid);
+    writeUnits(path, units);
+    uint64_t valueSize = UINT64_MAX;
+    valid = openCorrupted(path, header.valueOffsetsOffset + 8, &valueSize, sizeof(uint64_t));
+    assert(!valid);
+    writeUnits(path, units);
+    uint32_t keyOffset = 0;
+    valid = openCorrupted(path, header.keyOffsetsOffset + 4, &keyOffset, sizeof(uint32_t));
+    assert(!valid);
+    writeUnits(path, units);
+    keyOffset = 1 << 20;
+    valid = openCorrupted(path, header.keyOffsetsOffset + 8, &keyOffset, sizeof(uint32_t));
+    assert(!valid);
+    writeUnits(path, units);
+    valid = openCorrupted(path, header.keyOffsetsOffset, &keyOffset, 0);
+    assert(valid);
+
+    // test invalid files
+    FILE *file = fopen(path, "r+b");
+    fwrite("BAD", 1, 3, file);
+    fclose(file);
+    htMapped = htMappedOpen(path);
+    assert(!htMapped);
+    int res = truncate(path, 10);
+    assert(res == 0);
+    htMapped = htMappedOpen(path);
+    assert(!htMapped);
+    htMapped = htMappedOpen("/tmp/ht_mapped_missing");
+    assert(!htMapped);
+    unlink(path);
+}
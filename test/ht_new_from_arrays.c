@@ -0,0 +1,81 @@
+#include "../uhashtable/uhashtable.h"
+
+#define NUM_OF_KEYS 5000
+
+int main()
+{
+    HtType types[2] = { HT_CHAINED, HT_FLAT };
+    char names[NUM_OF_KEYS][30];
+    const char *keys[NUM_OF_KEYS];
+    void *values[NUM_OF_KEYS];
+
+    for (int i = 0; i < NUM_OF_KEYS; i++) {
+        snprintf(names[i], sizeof(names[i]), "unit%d.service", i);
+        keys[i] = names[i];
+        values[i] = names[i];
+    }
+
+    for (int t = 0; t < 2; t++) {
+        // test the bulk build with and without the duplicates check
+        for (int checkDup = 0; checkDup < 2; checkDup++) {
+            Ht *ht = htNewFromArrays(types[t], keys, values, NUM_OF_KEYS, NULL, NULL, checkDup);
+            assert(ht);
+            printf("Type %d: items = %d, capacity = %d\n", types[t], ht->numOfItems, ht->capacity);
+            assert(ht->numOfItems == NUM_OF_KEYS);
+            for (int i = 0; i < NUM_OF_KEYS; i++)
+                assert(htGet(ht, keys[i]) == values[i]);
+            // the hash table works as usual after the build
+            bool res = htAdd(ht, keys[0], NULL);
+            assert(!res);
+            res = htAdd(ht, "new.service", NULL);
+            assert(res);
+            res = htRemove(ht, keys[1]);
+            assert(res);
+            htRelease(&ht);
+        }
+
+        // test a duplicated key
+        keys[NUM_OF_KEYS - 1] = keys[10];
+        Ht *ht = htNewFromArrays(types[t], keys, values, NUM_OF_KEYS, NULL, NULL, true);
+        assert(!ht);
+        keys[NUM_OF_KEYS - 1] = names[NUM_OF_KEYS - 1];
+
+        // test the null and empty keys, they are rejected as htAdd() does
+        keys[20] = "";
+        ht = htNewFromArrays(types[t], keys, values, NUM_OF_KEYS, NULL, NULL, false);
+        assert(!ht);
+        keys[20] = NULL;
+        ht = htNewFromArrays(types[t], keys, values, NUM_OF_KEYS, NULL, NULL, false);
+        assert(!ht);
+        keys[20] = names[20];
+
+        // test the policy, the table never shrinks below the initial capacity
+        HtPolicy policy = { .growLoadFactor = 0.5, .shrinkLoadFactor = 0.125 };
+        ht = htNewFromArrays(types[t], keys, values, NUM_OF_KEYS, NULL, &policy, false);
+        assert(ht && ht->capacity >= NUM_OF_KEYS * 2);
+        int capacity = ht->capacity;
+        for (int i = 0; i < NUM_OF_KEYS; i++)
+            htRemove(ht, keys[i]);
+        assert(ht->numOfItems == 0 && ht->capacity >= capacity / 2);
+        htRelease(&ht);
+        HtPolicy full = { .growLoadFactor = 1, .shrinkDisabled = true };
+        ht = htNewFromArrays(HT_FLAT, keys, values, NUM_OF_KEYS, NULL, &full, false);
+        assert(!ht);
+
+        // test the release function
+        char **copies = malloc(3 * sizeof(char *));
+        for (int i = 0; i < 3; i++)
+            copies[i] = stringNew(keys[i]);
+        ht = htNewFromArrays(types[t], keys, (void **)copies, 3, objectRelease, NULL, true);
+        assert(ht && stringEquals(htGet(ht, keys[2]), keys[2]));
+        htRelease(&ht);
+        objectRelease(&copies);
+
+        // test an empty hash table
+        ht = htNewFromArrays(types[t], keys, values, 0, NULL, NULL, true);
+        assert(ht && ht->numOfItems == 0);
+        bool added = htAdd(ht, keys[0], NULL);
+        assert(added);
+        htRelease(&ht);
+    }
+}
@@ -0,0 +1,76 @@
+#include "../uhashtable/uhashtable.h"
+
+int main()
+{
+    int capacity = 8, numOfKeys = 10000;
+    HtType types[2] = { HT_CHAINED, HT_FLAT };
+
+    for (int t = 0; t < 2; t++) {
+        printf("\nType = %s\n", types[t] == HT_FLAT ? "flat" : "chained");
+
+        // test reserve: no intermediate resize
+        HtPolicy policy = { .growLoadFactor = 0.5, .shrinkLoadFactor = 0.125 };
+        Ht *ht = htNewWithPolicy(types[t], capacity, objectRelease, &policy);
+        htReserve(ht, numOfKeys);
+        int reserved = ht->capacity;
+        printf("Reserved capacity = %d\n", reserved);
+        for (int i = 0; i < numOfKeys; i++) {
+            char key[50] = { 0 };
+            snprintf(key, sizeof(key), "Domenico%d", i);
+            htAdd(ht, key, stringNew(key));
+            assert(ht->capacity == reserved);
+        }
+
+        // test shrink to fit
+        for (int i = 100; i < numOfKeys; i++) {
+            char key[50] = { 0 };
+            snprintf(key, sizeof(key), "Domenico%d", i);
+            htRemove(ht, key);
+        }
+        htShrinkToFit(ht);
+        printf("Capacity after shrink to fit = %d\n", ht->capacity);
+        assert(ht->capacity == 256);
+        for (int i = 0; i < 100; i++) {
+            char key[50] = { 0 };
+            snprintf(key, sizeof(key), "Domenico%d", i);
+            assert(stringEquals(htGet(ht, key), key));
+        }
+        htRelease(&ht);
+
+        // test churn around the grow threshold with shrink disabled
+        HtPolicy noShrink = { .growLoadFactor = 0.75, .minCapacity = 4, .shrinkDisabled = true };
+        ht = htNewWithPolicy(types[t], capacity, NULL, &noShrink);
+        for (int i = 0; i < 6; i++) {
+            char key[50] = { 0 };
+            snprintf(key, sizeof(key), "Key%d", i);
+            htAdd(ht, key, NULL);
+        }
+        int grown = ht->capacity;
+        for (int i = 0; i < 1000; i++) {
+            htRemove(ht, "Key0");
+            htAdd(ht, "Key0", NULL);
+            assert(ht->capacity == grown);
+        }
+        printf("Capacity after churn = %d\n", ht->capacity);
+        htRelease(&ht);
+
+        // test the invalid policies are rejected
+        HtPolicy noGrow = { .growLoadFactor = 0 };
+        ht = htNewWithPolicy(types[t], capacity, NULL, &noGrow);
+        assert(ht == NULL);
+        HtPolicy noHysteresis = { .growLoadFactor = 0.5, .shrinkLoadFactor = 0.25 };
+        ht = htNewWithPolicy(types[t], capacity, NULL, &noHysteresis);
+        assert(ht == NULL);
+        HtPolicy negativeMin = { .growLoadFactor = 0.5, .minCapacity = -1, .shrinkDisabled = true };
+        ht = htNewWithPolicy(types[t], capacity, NULL, &negativeMin);
+        assert(ht == NULL);
+    }
+
+    // an open addressing table must always contain an empty slot
+    HtPolicy full = { .growLoadFactor = 1, .shrinkDisabled = true };
+    Ht *flat = htNewWithPolicy(HT_FLAT, 8, NULL, &full);
+    assert(flat == NULL);
+    Ht *chained = htNewWithPolicy(HT_CHAINED, 8, NULL, &full);
+    assert(chained != NULL);
+    htRelease(&chained);
+}
@@ -0,0 +1,91 @@
+#include "../uhashtable/uhashtable.h"
+
+#define NUM_OF_READERS 4
+#define NUM_OF_KEYS 200
+#define NUM_OF_UPDATES 300
+
+static HtRcu *htRcu = NULL;
+static bool done = false;
+
+static int *intNew(int n)
+{
+    int *value = malloc(sizeof(int));
+    assert(value);
+    *value = n;
+    return value;
+}
+
+static void *reader(void *arg)
+{
+    int *lookups = arg;
+    char key[20];
+    do {
+        for (int i = 0; i < NUM_OF_KEYS; i++) {
+            snprintf(key, sizeof(key), "key%d", i);
+            // the value can be read even if a writer replaces it meanwhile
+            htRcuReadLock(htRcu);
+            int *value = htRcuGet(htRcu, key);
+            assert(value && *value % NUM_OF_KEYS == i);
+            htRcuReadUnlock(htRcu);
+            (*lookups)++;
+        }
+    } while (!__atomic_load_n(&done, __ATOMIC_ACQUIRE));
+
+    return NULL;
+}
+
+int main()
+{
+    pthread_t threads[NUM_OF_READERS];
+    int lookups[NUM_OF_READERS] = { 0 };
+    HtType types[2] = { HT_CHAINED, HT_FLAT };
+    char key[20];
+
+    for (int t = 0; t < 2; t++) {
+        // the hash table is built by a single thread
+        Ht *ht = htNewWithPolicy(types[t], 16, objectRelease, NULL);
+        for (int i = 0; i < NUM_OF_KEYS; i++) {
+            snprintf(key, sizeof(key), "key%d", i);
+            bool added = htAdd(ht, key, intNew(i));
+            assert(added);
+        }
+        htRcu = htRcuNew(&ht);
+        assert(!ht);
+        __atomic_store_n(&done, false, __ATOMIC_RELEASE);
+        for (int i = 0; i < NUM_OF_READERS; i++) {
+            lookups[i] = 0;
+            pthread_create(&threads[i], NULL, reader, &lookups[i]);
+        }
+
+        // test the updates while the readers are running
+        for (int n = 0; n < NUM_OF_UPDATES; n++) {
+            int i = n % NUM_OF_KEYS;
+            snprintf(key, sizeof(key), "key%d", i);
+            bool res = htRcuSet(htRcu, key, intNew(i + NUM_OF_KEYS * (n + 1)));
+            assert(res);
+            snprintf(key, sizeof(key), "new%d", n);
+            res = htRcuAdd(htRcu, key, intNew(n));
+            assert(res);
+            res = htRcuAdd(htRcu, key, NULL);
+            assert(!res);
+            if (n % 2 == 0) {
+                res = htRcuRemove(htRcu, key);
+                assert(res);
+            }
+        }
+        __atomic_store_n(&done, true, __ATOMIC_RELEASE);
+        for (int i = 0; i < NUM_OF_READERS; i++)
+            pthread_join(threads[i], NULL);
+
+        assert(htRcu->ht->numOfItems == NUM_OF_KEYS + NUM_OF_UPDATES / 2);
+        assert(!htRcuGet(htRcu, "new0"));
+        assert(*(int *)htRcuGet(htRcu, "new1") == 1);
+        bool res = htRcuRemove(htRcu, "new0");
+        assert(!res);
+        res = htRcuSet(htRcu, "new0", NULL);
+        assert(!res);
+        printf("Type %d: lookups = %d\n", types[t], lookups[0]);
+        htRcuRelease(&htRcu);
+        assert(!htRcu);
+    }
+}
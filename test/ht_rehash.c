@@ -0,0 +1,86 @@
+#include "../uhashtable/uhashtable.h"
+
+static bool checkKeys(Ht *ht, int from, int to)
+{
+    for (int i = from; i < to; i++) {
+        char key[50] = { 0 };
+        char value[50] = { 0 };
+        snprintf(key, sizeof(key), "Domenico%d", i);
+        snprintf(value, sizeof(value), "Panella%d", i);
+        if (!stringEquals(htGet(ht, key), value))
+            return false;
+    }
+    return true;
+}
+
+static int countItems(Ht *ht)
+{
+    int count = 0;
+    HtIterator *htIter = htGetIterator(ht);
+    while (htGetNext(htIter))
+        count++;
+    objectRelease(&htIter);
+    return count;
+}
+
+int main()
+{
+    int capacity = 16, numOfKeys = 100000, rehashSteps = 0;
+    Ht *ht = htNew(capacity, objectRelease);
+    htSetRehashStep(ht, 4);
+
+    // test add and incremental resize
+    for (int i = 0; i < numOfKeys; i++) {
+        char key[50] = { 0 };
+        char value[50] = { 0 };
+        snprintf(key, sizeof(key), "Domenico%d", i);
+        snprintf(value, sizeof(value), "Panella%d", i);
+        bool added = htAdd(ht, key, stringNew(value));
+        assert(added);
+        if (ht->htOldEntries) {
+            rehashSteps++;
+            /* The keys must be found both in the old and in the new hash entries. */
+            if (i % 9973 == 0) {
+                assert(checkKeys(ht, 0, i + 1));
+                assert(countItems(ht) == i + 1);
+            }
+        }
+    }
+    printf("Additions performed during a rehashing = %d\n", rehashSteps);
+    assert(rehashSteps > 0);
+    assert(checkKeys(ht, 0, numOfKeys));
+    assert(ht->numOfItems == numOfKeys);
+
+    // test set during a rehashing
+    htSet(ht, "Domenico9", stringNew("PanellaReplaced"));
+    assert(stringEquals(htGet(ht, "Domenico9"), "PanellaReplaced"));
+    htSet(ht, "Domenico9", stringNew("Panella9"));
+
+    // test remove and incremental resize
+    for (int i = 0; i < numOfKeys - 10; i++) {
+        char key[50] = { 0 };
+        snprintf(key, sizeof(key), "Domenico%d", i);
+        bool removed = htRemove(ht, key);
+        assert(removed);
+        if (i % 9973 == 0)
+            assert(checkKeys(ht, i + 1, numOfKeys));
+    }
+    assert(checkKeys(ht, numOfKeys - 10, numOfKeys));
+    assert(countItems(ht) == 10);
+
+    // disable the incremental rehashing
+    htSetRehashStep(ht, 0);
+    assert(!ht->htOldEntries);
+    assert(checkKeys(ht, numOfKeys - 10, numOfKeys));
+
+    /* Set debug data */
+    htSetDebugData(ht);
+
+    printf("\nSUMMARY\n");
+    printf("Capacity = %d\n", ht->capacity);
+    printf("Elements = %d\n", ht->numOfItems);
+    printf("Max collisions for entry = %d\n", ht->maxCollisionsForEntry);
+    printf("Total collisions = %d\n", ht->totCollisions);
+
+    htRelease(&ht);
+}
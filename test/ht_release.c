@@ -27,16 +27,16 @@ int main()
     Ht *ht = htNew(capacity, objectRelease);
     printf("Initial capacity = %d\n", capacity);
 
-    Array *htEntries = ht->htEntries;
-    for (int i = 0; i < htEntries->size; i++) {
+    HtEntry *htEntries = ht->htEntries;
+    for (int i = 0; i < ht->capacity; i++) {
         printf("Before Hash %d\n", i);
-        HtEntry *htEntry = arrayGet(htEntries, i);
-        if (htEntry) {
-            Array *htItems = htEntry->htItems;
-            int lenHtItems = htItems->size;
+        HtEntry *htEntry = &htEntries[i];
+        if (htEntry->size > 0) {
+            HtItem *htItems = htEntry->htItems;
+            int lenHtItems = htEntry->size;
             for (int j = 0; j < lenHtItems; j++) {
-                HtItem *htItem = arrayGet(htItems, j);
-                printf("    Key = %s, Value = %s\n", htItem->key, (char *)htItem->value);
+                HtItem *htItem = &htItems[j];
+                printf("    Key = %s, Value = %s\n", htItemKey(htItem), (char *)htItem->value);
             }
         }
     }
@@ -47,13 +47,13 @@ int main()
         char value[50] = { 0 };
         sprintf(key, "Domenico%d", i);
         sprintf(value, "Panella%d", i);
-        htAdd(&ht, key, stringNew(value));
+        htAdd(ht, key, stringNew(value));
     }
 
     // test set
-    //    htSet(&ht, "Domenico9", stringNew("PanellaReplaced"));
-    //    htSet(&ht, "Domenico9", NULL);
-    //    htSet(&ht, "Domenico9", NULL);
+    //    htSet(ht, "Domenico9", stringNew("PanellaReplaced"));
+    //    htSet(ht, "Domenico9", NULL);
+    //    htSet(ht, "Domenico9", NULL);
 
     // test get
     char *value = htGet(ht, "Domenico608");
@@ -67,30 +67,30 @@ int main()
     for (int i = 0; i < 1485; i++) {
         char key[50] = { 0 };
         sprintf(key, "Domenico%d", i);
-        if (htRemove(&ht, key)) {
+        if (htRemove(ht, key)) {
             printf("%s removed!\n", key);
         }
     }
 
-    //    if (htRemove(&ht, "Luigi"))
+    //    if (htRemove(ht, "Luigi"))
     //        printf("Luigi removed!\n");
-    //    if (htRemove(&ht, "Domenico"))
+    //    if (htRemove(ht, "Domenico"))
     //        printf("Domenico removed!\n");
-    //    if (htRemove(&ht, "Domenico1"))
+    //    if (htRemove(ht, "Domenico1"))
     //        printf("Domenico1 removed!\n");
-    //    if (htRemove(&ht, "Domenico2"))
+    //    if (htRemove(ht, "Domenico2"))
     //        printf("Domenico2 removed!\n");
-    //    if (htRemove(&ht, "Francesco"))
+    //    if (htRemove(ht, "Francesco"))
     //        printf("Francesco removed!\n");
-    //    if (htRemove(&ht, "Marianeve"))
+    //    if (htRemove(ht, "Marianeve"))
     //        printf("Marianeve removed!\n");
-    //    if (htRemove(&ht, "Michele"))
+    //    if (htRemove(ht, "Michele"))
     //        printf("Michele removed!\n");
-    //    if (htRemove(&ht, "Arturo"))
+    //    if (htRemove(ht, "Arturo"))
     //        printf("Arturo removed!\n");
-    //    if (htRemove(&ht, "Antonio"))
+    //    if (htRemove(ht, "Antonio"))
     //        printf("Antonio removed!\n");
-    //    if (htRemove(&ht, "Ciccio"))
+    //    if (htRemove(ht, "Ciccio"))
     //        printf("Ciccio removed!\n");
     //    else
     //        printf("Ciccio not removed!\n");
@@ -99,15 +99,15 @@ int main()
     htSetDebugData(ht);
 
     htEntries = ht->htEntries;
-    for (int i = 0; i < htEntries->size; i++) {
+    for (int i = 0; i < ht->capacity; i++) {
         printf("After Hash %d\n", i);
-        HtEntry *htEntry = arrayGet(htEntries, i);
-        if (htEntry) {
-            Array *htItems = htEntry->htItems;
-            int lenHtItems = htItems->size;
+        HtEntry *htEntry = &htEntries[i];
+        if (htEntry->size > 0) {
+            HtItem *htItems = htEntry->htItems;
+            int lenHtItems = htEntry->size;
             for (int j = 0; j < lenHtItems; j++) {
-                HtItem *htItem = arrayGet(htItems, j);
-                printf("    Key = %s, Value = %s\n", htItem->key, (char *)htItem->value);
+                HtItem *htItem = &htItems[j];
+                printf("    Key = %s, Value = %s\n", htItemKey(htItem), (char *)htItem->value);
             }
         }
     }
@@ -6,34 +6,34 @@ int main()
     Ht *ht = htNew(capacity, NULL);
     printf("Initial capacity = %d\n", capacity);
 
-    Array *htEntries = ht->htEntries;
-    for (int i = 0; i < htEntries->size; i++) {
+    HtEntry *htEntries = ht->htEntries;
+    for (int i = 0; i < ht->capacity; i++) {
         printf("Before Hash %d\n", i);
-        HtEntry *htEntry = arrayGet(htEntries, i);
-        if (htEntry) {
-            Array *htItems = htEntry->htItems;
-            int lenHtItems = htItems->size;
+        HtEntry *htEntry = &htEntries[i];
+        if (htEntry->size > 0) {
+            HtItem *htItems = htEntry->htItems;
+            int lenHtItems = htEntry->size;
             for (int j = 0; j < lenHtItems; j++) {
-                HtItem *htItem = arrayGet(htItems, j);
-                printf("    Key = %s, Value = %s\n", htItem->key, (char *)htItem->value);
+                HtItem *htItem = &htItems[j];
+                printf("    Key = %s, Value = %s\n", htItemKey(htItem), (char *)htItem->value);
             }
         }
     }
 
     // test add and resize
-    htAdd(&ht, "Domenico", "Panella");
-    htAdd(&ht, "Domenico1", "Panella1");
-    htAdd(&ht, "Domenico2", "Panella2");
-    htAdd(&ht, "Antonio", "Esposito");
-    htAdd(&ht, "Francesco", "Riccio");
-    htAdd(&ht, "Domenico", "Panella");
-    htAdd(&ht, "Luigi", "Gallo");
-    htAdd(&ht, "Marianeve", "Maresca");
-    htAdd(&ht, "Michele", "Oliva");
-    htAdd(&ht, "Arturo", "Cirillo");
+    htAdd(ht, "Domenico", "Panella");
+    htAdd(ht, "Domenico1", "Panella1");
+    htAdd(ht, "Domenico2", "Panella2");
+    htAdd(ht, "Antonio", "Esposito");
+    htAdd(ht, "Francesco", "Riccio");
+    htAdd(ht, "Domenico", "Panella");
+    htAdd(ht, "Luigi", "Gallo");
+    htAdd(ht, "Marianeve", "Maresca");
+    htAdd(ht, "Michele", "Oliva");
+    htAdd(ht, "Arturo", "Cirillo");
 
     // test set
-    //    htSet(&ht, "Domenico", stringNew("Panella2"));
+    //    htSet(ht, "Domenico", stringNew("Panella2"));
 
     // test get
     //    HtItem *htItem = htGet(ht, "Domenico");
@@ -44,25 +44,25 @@ int main()
     //        printf("Ciccio key is not present!\n");
 
     // test remove and resize
-    if (htRemove(&ht, "Luigi"))
+    if (htRemove(ht, "Luigi"))
         printf("Luigi removed!\n");
-    if (htRemove(&ht, "Domenico"))
+    if (htRemove(ht, "Domenico"))
         printf("Domenico removed!\n");
-    if (htRemove(&ht, "Domenico1"))
+    if (htRemove(ht, "Domenico1"))
         printf("Domenico1 removed!\n");
-    if (htRemove(&ht, "Domenico2"))
+    if (htRemove(ht, "Domenico2"))
         printf("Domenico2 removed!\n");
-    if (htRemove(&ht, "Francesco"))
+    if (htRemove(ht, "Francesco"))
         printf("Francesco removed!\n");
-    //    if (htRemove(&ht, "Marianeve"))
+    //    if (htRemove(ht, "Marianeve"))
     //        printf("Marianeve removed!\n");
-    //    if (htRemove(&ht, "Michele"))
+    //    if (htRemove(ht, "Michele"))
     //        printf("Michele removed!\n");
-    //    if (htRemove(&ht, "Arturo"))
+    //    if (htRemove(ht, "Arturo"))
     //        printf("Arturo removed!\n");
-    //    if (htRemove(&ht, "Antonio"))
+    //    if (htRemove(ht, "Antonio"))
     //        printf("Antonio removed!\n");
-    //    if (htRemove(&ht, "Ciccio"))
+    //    if (htRemove(ht, "Ciccio"))
     //        printf("Ciccio removed!\n");
     //    else
     //        printf("Ciccio not removed!\n");
@@ -71,15 +71,15 @@ int main()
     htSetDebugData(ht);
 
     htEntries = ht->htEntries;
-    for (int i = 0; i < htEntries->size; i++) {
+    for (int i = 0; i < ht->capacity; i++) {
         printf("After Hash %d\n", i);
-        HtEntry *htEntry = arrayGet(htEntries, i);
-        if (htEntry) {
-            Array *htItems = htEntry->htItems;
-            int lenHtItems = htItems->size;
+        HtEntry *htEntry = &htEntries[i];
+        if (htEntry->size > 0) {
+            HtItem *htItems = htEntry->htItems;
+            int lenHtItems = htEntry->size;
             for (int j = 0; j < lenHtItems; j++) {
-                HtItem *htItem = arrayGet(htItems, j);
-                printf("    Key = %s, Value = %s\n", htItem->key, (char *)htItem->value);
+                HtItem *htItem = &htItems[j];
+                printf("    Key = %s, Value = %s\n", htItemKey(htItem), (char *)htItem->value);
             }
         }
     }
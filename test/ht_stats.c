@@ -0,0 +1,82 @@
+#include "../uhashtable/uhashtable.h"
+
+#define NUM_OF_KEYS 3000
+
+int main()
+{
+    HtType types[2] = { HT_CHAINED, HT_FLAT };
+
+    for (int t = 0; t < 2; t++) {
+        Ht *ht = htNewWithPolicy(types[t], 8, NULL, NULL);
+        for (int i = 0; i < NUM_OF_KEYS; i++) {
+            char key[50];
+            // the long keys are not stored into the items
+            const char *format = i % 2 ? "unit%d.service" : "a-very-long-unit-name-%d.service";
+            snprintf(key, sizeof(key), format, i);
+            bool added = htAdd(ht, key, (void *)(long)(i + 1));
+            assert(added);
+        }
+        for (int i = 0; i < 100; i++) {
+            char key[50];
+            snprintf(key, sizeof(key), "missing%d", i);
+            void *value = htGet(ht, key);
+            assert(!value);
+            snprintf(key, sizeof(key), "unit%d.service", 2 * i + 1);
+            value = htGet(ht, key);
+            assert(value);
+        }
+        const char *keys[3] = { "unit1.service", "unit3.service", "missing" };
+        void *values[3];
+        int found = htGetMany(ht, keys, 3, values);
+        assert(found == 2);
+
+        HtStats htStats = { 0 };
+        bool res = htGetStats(NULL, &htStats);
+        assert(!res);
+        res = htGetStats(ht, &htStats);
+        assert(res);
+        printf("Type %d: items = %d, capacity = %d, load factor = %.2f\n", types[t],
+               htStats.numOfItems, htStats.capacity, htStats.loadFactor);
+        printf("    probe length: max = %d, avg = %.3f, histogram =", htStats.maxProbeLength,
+               htStats.avgProbeLength);
+        int numOfItems = 0;
+        for (int i = 0; i < HT_STATS_HISTOGRAM_SIZE; i++) {
+            printf(" %d", htStats.probeHistogram[i]);
+            numOfItems += htStats.probeHistogram[i];
+        }
+        printf("\n    bytes: buckets = %zu, items = %zu, keys = %zu\n", htStats.bucketBytes,
+               htStats.itemBytes, htStats.keyBytes);
+        printf("    hits = %" PRIu64 ", misses = %" PRIu64 ", resizes = %" PRIu64
+               ", resize time = %" PRIu64 " ns\n",
+               htStats.counters.hits, htStats.counters.misses, htStats.counters.numOfResizes,
+               htStats.counters.resizeTime);
+        assert(numOfItems == NUM_OF_KEYS);
+        assert(htStats.capacity == ht->capacity);
+        assert(htStats.loadFactor > 0 && htStats.loadFactor < 1);
+        assert(htStats.bucketBytes > 0);
+        assert((htStats.itemBytes > 0) == (types[t] == HT_CHAINED));
+        assert(htStats.keyBytes >= (NUM_OF_KEYS / 2) * strlen("a-very-long-unit-name-0.service"));
+#ifdef HT_STATS
+        assert(htStats.counters.hits == 102 && htStats.counters.misses == 101);
+        assert(htStats.counters.numOfResizes > 0);
+        htResetCounters(ht);
+        res = htGetStats(ht, &htStats);
+        assert(res);
+        assert(htStats.counters.hits == 0 && htStats.counters.numOfResizes == 0);
+#else
+        assert(htStats.counters.hits == 0 && htStats.counters.numOfResizes == 0);
+#endif
+
+        // test the borrowed keys, they are not owned by the hash table
+        Ht *htBorrow = htNewWithPolicy(types[t], 8, NULL, NULL);
+        res = htSetKeyMode(htBorrow, HT_KEY_BORROW);
+        assert(res);
+        res = htAdd(htBorrow, keys[0], NULL);
+        assert(res);
+        res = htGetStats(htBorrow, &htStats);
+        assert(res);
+        assert(htStats.keyBytes == 0 && htStats.probeHistogram[0] == 1);
+        htRelease(&htBorrow);
+        htRelease(&ht);
+    }
+}
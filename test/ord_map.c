@@ -0,0 +1,144 @@
+#include "../uordmap/uordmap.h"
+
+#define NUM_OF_KEYS 10000
+
+static int compareKeys(const void *a, const void *b)
+{
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+static void checkOrder(OrdMap *ordMap, char **sorted, bool *removed, int numOfKeys)
+{
+    OrdMapIterator ordMapIter;
+    const char *key = NULL;
+    void *value = NULL;
+    int i = 0;
+
+    ordMapIterFirst(ordMap, &ordMapIter);
+    while (ordMapIterNext(&ordMapIter, &key, &value)) {
+        while (removed[i])
+            i++;
+        assert(stringEquals(key, sorted[i]));
+        assert(stringEquals(value, sorted[i]));
+        i++;
+    }
+    while (i < numOfKeys && removed[i])
+        i++;
+    assert(i == numOfKeys);
+}
+
+int main()
+{
+    char **keys = calloc(NUM_OF_KEYS, sizeof(char *));
+    char **sorted = calloc(NUM_OF_KEYS, sizeof(char *));
+    bool *removed = calloc(NUM_OF_KEYS, sizeof(bool));
+    const char *prefixes[4] = { "network-", "getty-", "system-", "user-" };
+    OrdMap *ordMap = ordMapNew(objectRelease);
+
+    srand(15);
+    for (int i = 0; i < NUM_OF_KEYS; i++) {
+        char name[40];
+        snprintf(name, sizeof(name), "%s%d.service", prefixes[rand() % 4], i);
+        keys[i] = stringNew(name);
+        sorted[i] = keys[i];
+    }
+    qsort(sorted, NUM_OF_KEYS, sizeof(char *), compareKeys);
+
+    // test the addition in random order
+    bool res;
+    for (int i = 0; i < NUM_OF_KEYS; i++) {
+        res = ordMapAdd(ordMap, keys[i], stringNew(keys[i]));
+        assert(res);
+    }
+    assert(ordMap->numOfItems == NUM_OF_KEYS);
+    res = ordMapAdd(ordMap, keys[0], NULL);
+    assert(!res);
+    res = ordMapAdd(ordMap, "", NULL);
+    assert(!res);
+    for (int i = 0; i < NUM_OF_KEYS; i++)
+        assert(stringEquals(ordMapGet(ordMap, keys[i]), keys[i]));
+    assert(!ordMapGet(ordMap, "network-"));
+    checkOrder(ordMap, sorted, removed, NUM_OF_KEYS);
+
+    // test the remotion of the half of the keys
+    for (int i = 0; i < NUM_OF_KEYS; i += 2) {
+        res = ordMapRemove(ordMap, sorted[i]);
+        assert(res);
+        removed[i] = true;
+    }
+    res = ordMapRemove(ordMap, sorted[0]);
+    assert(!res);
+    assert(ordMap->numOfItems == NUM_OF_KEYS / 2);
+    checkOrder(ordMap, sorted, removed, NUM_OF_KEYS);
+
+    // test the lower bound
+    OrdMapIterator ordMapIter;
+    const char *key = NULL;
+    ordMapIterLowerBound(ordMap, &ordMapIter, sorted[100]);
+    res = ordMapIterNext(&ordMapIter, &key, NULL);
+    assert(res && stringEquals(key, sorted[101]));
+    ordMapIterLowerBound(ordMap, &ordMapIter, sorted[101]);
+    res = ordMapIterNext(&ordMapIter, &key, NULL);
+    assert(res && stringEquals(key, sorted[101]));
+    ordMapIterLowerBound(ordMap, &ordMapIter, "zzz");
+    res = ordMapIterNext(&ordMapIter, &key, NULL);
+    assert(!res);
+
+    // test the prefix scans
+    for (int p = 0; p < 4; p++) {
+        int expected = 0, found = 0;
+        for (int i = 0; i < NUM_OF_KEYS; i++) {
+            if (!removed[i] && stringStartsWithStr(sorted[i], prefixes[p]))
+                expected++;
+        }
+        ordMapIterPrefix(ordMap, &ordMapIter, prefixes[p]);
+        while (ordMapIterNext(&ordMapIter, &key, NULL)) {
+            assert(stringStartsWithStr(key, prefixes[p]));
+            found++;
+        }
+        printf("Prefix '%s': %d keys\n", prefixes[p], found);
+        assert(found == expected);
+    }
+    ordMapIterPrefix(ordMap, &ordMapIter, "unknown-");
+    res = ordMapIterNext(&ordMapIter, NULL, NULL);
+    assert(!res);
+
+    // test the iterator invalidation
+    ordMapIterFirst(ordMap, &ordMapIter);
+    res = ordMapIterNext(&ordMapIter, NULL, NULL);
+    assert(res);
+    res = ordMapAdd(ordMap, sorted[0], stringNew(sorted[0]));
+    assert(res);
+    removed[0] = false;
+    res = ordMapIterNext(&ordMapIter, NULL, NULL);
+    assert(!res);
+
+    // test the replacement
+    res = ordMapSet(ordMap, sorted[1], stringNew(sorted[1]));
+    assert(res);
+    res = ordMapSet(ordMap, sorted[2], NULL);
+    assert(!res);
+    checkOrder(ordMap, sorted, removed, NUM_OF_KEYS);
+
+    // test the remotion of all the keys
+    for (int i = 0; i < NUM_OF_KEYS; i++) {
+        if (!removed[i]) {
+            res = ordMapRemove(ordMap, sorted[i]);
+            assert(res);
+        }
+    }
+    assert(ordMap->numOfItems == 0);
+    ordMapIterFirst(ordMap, &ordMapIter);
+    res = ordMapIterNext(&ordMapIter, NULL, NULL);
+    assert(!res);
+    res = ordMapAdd(ordMap, sorted[0], stringNew(sorted[0]));
+    assert(res);
+    ordMapRelease(&ordMap);
+    assert(!ordMap);
+
+    for (int i = 0; i < NUM_OF_KEYS; i++)
+        objectRelease(&keys[i]);
+    objectRelease(&keys);
+    objectRelease(&sorted);
+    objectRelease(&removed);
+}
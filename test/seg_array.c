@@ -0,0 +1,71 @@
+#include "../ulib.h"
+
+#define NUM_OF_ELEMENTS 100000
+
+typedef struct {
+    int id;
+    char *msg;
+} Event;
+
+static void eventRelease(void *element)
+{
+    objectRelease(&((Event *)element)->msg);
+}
+
+int main()
+{
+    SegArray *segArray = segArrayNew(sizeof(Event), eventRelease);
+    bool removed = segArrayRemoveLast(segArray);
+    assert(!segArrayGet(segArray, 0) && !removed);
+
+    // the addresses are stable while the array grows
+    Event *first = NULL;
+    for (int i = 0; i < NUM_OF_ELEMENTS; i++) {
+        char msg[30];
+        snprintf(msg, sizeof(msg), "event %d", i);
+        Event event = { .id = i, .msg = stringNew(msg) };
+        Event *added = segArrayAdd(segArray, &event);
+        assert(added && added->id == i);
+        if (i == 0)
+            first = added;
+    }
+    printf("Size = %d, chunks = %d\n", segArray->size, segArray->numOfChunks);
+    assert(segArray->size == NUM_OF_ELEMENTS);
+    assert(first == segArrayGet(segArray, 0) && first->id == 0);
+    for (int i = 0; i < NUM_OF_ELEMENTS; i += 997) {
+        Event *event = segArrayGet(segArray, i);
+        assert(event->id == i && atoi(event->msg + 6) == i);
+    }
+    assert(!segArrayGet(segArray, NUM_OF_ELEMENTS) && !segArrayGet(segArray, -1));
+
+    // test the iterator
+    SegArrayIterator segArrayIter;
+    Event *event = NULL;
+    int count = 0;
+    segArrayIterInit(segArray, &segArrayIter);
+    while (segArrayIterNext(&segArrayIter, (void **)&event))
+        assert(event->id == count++);
+    assert(count == NUM_OF_ELEMENTS);
+
+    // test the remotion of the last elements
+    for (int i = 0; i < (1 << SEG_ARRAY_CHUNK_SHIFT); i++) {
+        removed = segArrayRemoveLast(segArray);
+        assert(removed);
+    }
+    assert(segArray->size == NUM_OF_ELEMENTS - (1 << SEG_ARRAY_CHUNK_SHIFT));
+
+    // the chunks are reused after the clear
+    int numOfChunks = segArray->numOfChunks;
+    segArrayClear(segArray);
+    assert(segArray->size == 0 && segArray->numOfChunks == numOfChunks);
+    Event *zeroed = segArrayAdd(segArray, NULL);
+    assert(zeroed == first && zeroed->id == 0 && !zeroed->msg);
+    segArrayRelease(&segArray);
+    assert(!segArray);
+
+    // test a NULL array
+    SegArrayIterator segArrayNullIter = { 0 };
+    segArrayIterInit(NULL, &segArrayNullIter);
+    bool found = segArrayIterNext(&segArrayNullIter, (void **)&event);
+    assert(!found);
+}
@@ -0,0 +1,107 @@
+#include "../uhashtable/uhashtable.h"
+
+#define NUM_OF_KEYS 5000
+
+int main()
+{
+    StrSet *strSet1 = strSetNew(8);
+    StrSet *strSet2 = strSetNew(8);
+
+    // the first set contains the multiples of 2, the second one the multiples of 3
+    for (int i = 0; i < NUM_OF_KEYS; i++) {
+        char key[40];
+        snprintf(key, sizeof(key), "unit%d.service", i);
+        bool added = (i % 2 != 0 || strSetAdd(strSet1, key)) &&
+                     (i % 3 != 0 || strSetAdd(strSet2, key));
+        assert(added);
+    }
+    bool res = strSetAdd(strSet1, "unit0.service");
+    assert(!res);
+    res = strSetAdd(strSet1, "") || strSetAdd(strSet1, NULL);
+    assert(!res);
+    assert(strSet1->numOfItems == (NUM_OF_KEYS + 1) / 2);
+    for (int i = 0; i < NUM_OF_KEYS; i++) {
+        char key[40];
+        snprintf(key, sizeof(key), "unit%d.service", i);
+        assert(strSetContains(strSet1, key) == (i % 2 == 0));
+        assert(strSetContains(strSet2, key) == (i % 3 == 0));
+    }
+    assert(!strSetContains(strSet1, NULL));
+
+    // test the union and the intersection
+    StrSet *htUnion = strSetUnion(strSet1, strSet2);
+    StrSet *htIntersection = strSetIntersection(strSet1, strSet2);
+    printf("Union = %d, intersection = %d\n", htUnion->numOfItems, htIntersection->numOfItems);
+    for (int i = 0; i < NUM_OF_KEYS; i++) {
+        char key[40];
+        snprintf(key, sizeof(key), "unit%d.service", i);
+        assert(strSetContains(htUnion, key) == (i % 2 == 0 || i % 3 == 0));
+        assert(strSetContains(htIntersection, key) == (i % 6 == 0));
+    }
+
+    // test the iteration
+    StrSetIterator strSetIter;
+    const char *key = NULL;
+    int count = 0;
+    strSetIterInit(htIntersection, &strSetIter);
+    while (strSetIterNext(&strSetIter, &key)) {
+        assert(atoi(key + 4) % 6 == 0);
+        count++;
+    }
+    assert(count == htIntersection->numOfItems);
+
+    // test the remotion
+    for (int i = 0; i < NUM_OF_KEYS; i += 2) {
+        char key[40];
+        snprintf(key, sizeof(key), "unit%d.service", i);
+        res = strSetRemove(strSet1, key);
+        assert(res);
+        res = strSetRemove(strSet1, key);
+        assert(!res);
+    }
+    printf("Items = %d, capacity = %d\n", strSet1->numOfItems, strSet1->capacity);
+    assert(strSet1->numOfItems == 0 && strSet1->capacity == 8);
+    StrSet *htEmpty = strSetIntersection(strSet1, strSet2);
+    assert(htEmpty->numOfItems == 0);
+
+    strSetRelease(&htEmpty);
+    strSetRelease(&htUnion);
+    strSetRelease(&htIntersection);
+    strSetRelease(&strSet1);
+    strSetRelease(&strSet2);
+    assert(!strSet1);
+
+    // test the resize policy, the union follows the policy of the first set
+    HtPolicy policy = { .growLoadFactor = 0.5, .shrinkLoadFactor = 0.2, .minCapacity = 16 };
+    strSet1 = strSetNewWithPolicy(4, &policy);
+    assert(strSet1->capacity == 16);
+    for (int i = 0; i < 8; i++) {
+        char key[40];
+        snprintf(key, sizeof(key), "unit%d.service", i);
+        strSetAdd(strSet1, key);
+    }
+    assert(strSet1->capacity == 32);
+    htUnion = strSetUnion(strSet1, strSet1);
+    assert(htUnion->numOfItems == 8 && htUnion->capacity == 64);
+    assert(htUnion->policy.growLoadFactor == policy.growLoadFactor);
+    for (int i = 0; i < 8; i++) {
+        char key[40];
+        snprintf(key, sizeof(key), "unit%d.service", i);
+        strSetRemove(strSet1, key);
+    }
+    assert(strSet1->capacity == 16);
+    strSetRelease(&htUnion);
+    strSetRelease(&strSet1);
+
+    // test an invalid policy: an open addressing set needs an empty slot
+    HtPolicy full = { .growLoadFactor = 1, .shrinkDisabled = true };
+    strSet1 = strSetNewWithPolicy(4, &full);
+    assert(strSet1 == NULL);
+
+    // test a NULL hash set
+    StrSetIterator strSetNullIter = { 0 };
+    const char *nullKey = NULL;
+    strSetIterInit(NULL, &strSetNullIter);
+    bool found = strSetIterNext(&strSetNullIter, &nullKey);
+    assert(!found);
+}
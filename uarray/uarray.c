@@ -8,6 +8,32 @@ See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
 
 #include "../ulib.h"
 
+/* The ranges shorter than this size are sorted by insertion. */
+#define ARRAY_SORT_THRESHOLD 16
+
+/* String with its length, computed once before sorting */
+typedef struct {
+    const char *str;
+    size_t len;
+} ArrayStrKey;
+
+static void arraySetCapacity(Array *array, int capacity)
+{
+    void **arr = realloc(array->arr, capacity * sizeof(void *));
+    assert(arr);
+    array->arr = arr;
+    array->capacity = capacity;
+}
+
+static void arrayGrow(Array *array, int size)
+{
+    /* The capacity is doubled, so the reallocations are logarithmic in the size. */
+    if (size > array->capacity) {
+        int capacity = array->capacity > 0 ? array->capacity * 2 : 1;
+        arraySetCapacity(array, capacity > size ? capacity : size);
+    }
+}
+
 Array *arrayNew(void (*releaseFn)(void **))
 {
     Array *array = calloc(1, sizeof(Array));
@@ -15,6 +41,7 @@ Array *arrayNew(void (*releaseFn)(void **))
     array->size = 0;
     array->arr = calloc(1, sizeof(void *));
     assert(array->arr);
+    array->capacity = 1;
     if (releaseFn)
         array->releaseFn = releaseFn;
 
@@ -29,6 +56,7 @@ Array *arrayNewWithAmount(int amount, void (*releaseFn)(void **))
         array->size = amount;
         array->arr = calloc(amount, sizeof(void *));
         assert(array->arr);
+        array->capacity = amount;
         if (releaseFn)
             array->releaseFn = releaseFn;
         return array;
@@ -40,13 +68,8 @@ Array *arrayNewWithAmount(int amount, void (*releaseFn)(void **))
 bool arrayAdd(Array *array, void *element)
 {
     if (array) {
-        int size = array->size++;
-        void ***arr = &array->arr;
-        if (size > 0) {
-            *arr = realloc(*arr, (size + 1) * sizeof(void *));
-            assert(*arr);
-        }
-        (*arr)[size] = element;
+        arrayGrow(array, array->size + 1);
+        array->arr[array->size++] = element;
         return true;
     }
 
@@ -60,13 +83,11 @@ bool arrayInsertAt(Array *array, int idx, void *element)
         if (idx == *size)
             return arrayAdd(array, element);
         if (idx < *size) {
+            arrayGrow(array, *size + 1);
+            void **arr = array->arr;
+            memmove(arr + idx + 1, arr + idx, (*size - idx) * sizeof(void *));
+            arr[idx] = element;
             (*size)++;
-            void ***arr = &array->arr;
-            *arr = realloc(*arr, (*size) * sizeof(void *));
-            assert(*arr);
-            for (int i = (*size - 1); i > idx; i--)
-                (*arr)[i] = (*arr)[i - 1];
-            (*arr)[idx] = element;
             return true;
         }
     }
@@ -117,18 +138,78 @@ bool arrayRemove(Array *array, void *element)
 void arrayRelease(Array **array)
 {
     if (*array) {
-        void **arr = (*array)->arr;
-        void (*releaseFn)(void **) = (*array)->releaseFn;
-        if (releaseFn) {
-            int *size = &(*array)->size;
-            for (int i = 0; i < *size;)
-                arrayRemoveAt((*array), i);
-        }
-        objectRelease(&arr);
+        arrayClear(*array);
+        objectRelease(&(*array)->arr);
         objectRelease(array);
     }
 }
 
+bool arraySwapRemoveAt(Array *array, int idx)
+{
+    if (array && idx >= 0 && idx < array->size) {
+        void **arr = array->arr;
+        if (array->releaseFn)
+            (*array->releaseFn)(&(arr[idx]));
+        /* The last element takes the place of the removed one. */
+        arr[idx] = arr[--array->size];
+        return true;
+    }
+
+    return false;
+}
+
+bool arrayRemoveRange(Array *array, int idx, int count)
+{
+    if (array && idx >= 0 && count >= 0 && count <= array->size - idx) {
+        void **arr = array->arr;
+        if (array->releaseFn) {
+            for (int i = idx; i < idx + count; i++)
+                (*array->releaseFn)(&(arr[i]));
+        }
+        /* The tail is moved once for all the removed elements. */
+        memmove(arr + idx, arr + idx + count, (array->size - idx - count) * sizeof(void *));
+        array->size -= count;
+        return true;
+    }
+
+    return false;
+}
+
+int arrayRemoveIf(Array *array, bool (*predicateFn)(void *, void *), void *data)
+{
+    int removed = 0;
+
+    if (array && predicateFn) {
+        void **arr = array->arr;
+        int size = array->size, j = 0;
+        /* Single compaction pass: the kept elements are moved back once. */
+        for (int i = 0; i < size; i++) {
+            if ((*predicateFn)(arr[i], data)) {
+                if (array->releaseFn)
+                    (*array->releaseFn)(&(arr[i]));
+            } else {
+                arr[j++] = arr[i];
+            }
+        }
+        removed = size - j;
+        array->size = j;
+    }
+
+    return removed;
+}
+
+void arrayClear(Array *array)
+{
+    if (array) {
+        if (array->releaseFn) {
+            void **arr = array->arr;
+            for (int i = 0; i < array->size; i++)
+                (*array->releaseFn)(&(arr[i]));
+        }
+        array->size = 0;
+    }
+}
+
 bool arraySet(Array *array, void *element, int idx)
 {
     if (array && idx < array->size) {
@@ -190,3 +271,281 @@ int arrayGetIdx(Array *array, void *element)
 
     return -1;
 }
+
+bool arrayReserve(Array *array, int capacity)
+{
+    if (array && capacity >= 0) {
+        if (capacity > array->capacity)
+            arraySetCapacity(array, capacity);
+        return true;
+    }
+
+    return false;
+}
+
+bool arrayShrinkToFit(Array *array)
+{
+    if (array) {
+        /* As for a new array, at least one element is allocated. */
+        int capacity = array->size > 0 ? array->size : 1;
+        if (capacity < array->capacity)
+            arraySetCapacity(array, capacity);
+        return true;
+    }
+
+    return false;
+}
+
+/* SORT */
+
+static inline void arraySwap(void **arr, int i, int j)
+{
+    void *tmp = arr[i];
+    arr[i] = arr[j];
+    arr[j] = tmp;
+}
+
+static void arrayInsertionSort(void **arr, int lo, int hi,
+                               int (*compareFn)(const void *, const void *))
+{
+    /* The equal elements are never moved across each other, so it is stable. */
+    for (int i = lo + 1; i < hi; i++) {
+        void *element = arr[i];
+        int j = i;
+        for (; j > lo && (*compareFn)(arr[j - 1], element) > 0; j--)
+            arr[j] = arr[j - 1];
+        arr[j] = element;
+    }
+}
+
+static void arraySiftDown(void **arr, int lo, int root, int size,
+                          int (*compareFn)(const void *, const void *))
+{
+    for (int child; (child = 2 * root + 1) < size; root = child) {
+        if (child + 1 < size && (*compareFn)(arr[lo + child], arr[lo + child + 1]) < 0)
+            child++;
+        if ((*compareFn)(arr[lo + root], arr[lo + child]) >= 0)
+            return;
+        arraySwap(arr, lo + root, lo + child);
+    }
+}
+
+static void arrayHeapSort(void **arr, int lo, int hi,
+                          int (*compareFn)(const void *, const void *))
+{
+    int size = hi - lo;
+    for (int i = size / 2 - 1; i >= 0; i--)
+        arraySiftDown(arr, lo, i, size, compareFn);
+    for (int i = size - 1; i > 0; i--) {
+        arraySwap(arr, lo, lo + i);
+        arraySiftDown(arr, lo, 0, i, compareFn);
+    }
+}
+
+static inline int arraySortDepth(int size)
+{
+    /* Twice the logarithm of the size */
+    int depth = 0;
+    for (; size > 1; size >>= 1)
+        depth += 2;
+
+    return depth;
+}
+
+static void arrayIntroSort(void **arr, int lo, int hi, int depth,
+                           int (*compareFn)(const void *, const void *))
+{
+    while (hi - lo > ARRAY_SORT_THRESHOLD) {
+        /* Too many bad pivots: the heap sort bounds the worst case to O(n log n). */
+        if (depth-- == 0) {
+            arrayHeapSort(arr, lo, hi, compareFn);
+            return;
+        }
+        /* Median of three, then Hoare partition around the middle element. */
+        int mid = lo + (hi - lo) / 2;
+        if ((*compareFn)(arr[mid], arr[lo]) < 0)
+            arraySwap(arr, mid, lo);
+        if ((*compareFn)(arr[hi - 1], arr[mid]) < 0) {
+            arraySwap(arr, hi - 1, mid);
+            if ((*compareFn)(arr[mid], arr[lo]) < 0)
+                arraySwap(arr, mid, lo);
+        }
+        void *pivot = arr[mid];
+        int i = lo - 1, j = hi;
+        for (;;) {
+            do
+                i++;
+            while ((*compareFn)(arr[i], pivot) < 0);
+            do
+                j--;
+            while ((*compareFn)(arr[j], pivot) > 0);
+            if (i >= j)
+                break;
+            arraySwap(arr, i, j);
+        }
+        /* The smaller part is sorted by recursion, so the stack depth is logarithmic. */
+        if (j + 1 - lo < hi - j - 1) {
+            arrayIntroSort(arr, lo, j + 1, depth, compareFn);
+            lo = j + 1;
+        } else {
+            arrayIntroSort(arr, j + 1, hi, depth, compareFn);
+            hi = j + 1;
+        }
+    }
+    arrayInsertionSort(arr, lo, hi, compareFn);
+}
+
+static void arrayMergeSort(void **arr, void **tmp, int lo, int hi,
+                           int (*compareFn)(const void *, const void *))
+{
+    if (hi - lo <= ARRAY_SORT_THRESHOLD) {
+        arrayInsertionSort(arr, lo, hi, compareFn);
+        return;
+    }
+    int mid = lo + (hi - lo) / 2;
+    arrayMergeSort(arr, tmp, lo, mid, compareFn);
+    arrayMergeSort(arr, tmp, mid, hi, compareFn);
+    /* The halves are already in order */
+    if ((*compareFn)(arr[mid - 1], arr[mid]) <= 0)
+        return;
+    memcpy(tmp + lo, arr + lo, (mid - lo) * sizeof(void *));
+    int i = lo, j = mid, k = lo;
+    /* On equal elements the left one is taken first, so the sort is stable. */
+    while (i < mid && j < hi)
+        arr[k++] = (*compareFn)(tmp[i], arr[j]) <= 0 ? tmp[i++] : arr[j++];
+    while (i < mid)
+        arr[k++] = tmp[i++];
+}
+
+static int arrayStrKeyCompare(const void *element1, const void *element2)
+{
+    const ArrayStrKey *key1 = element1, *key2 = element2;
+    /* The NULL strings precede the others. */
+    if (!key1->str || !key2->str)
+        return (key1->str != NULL) - (key2->str != NULL);
+    /* Same order of strcmp() without looking for the terminator. */
+    size_t len = key1->len < key2->len ? key1->len : key2->len;
+    int res = memcmp(key1->str, key2->str, len);
+    if (res == 0)
+        res = (key1->len > key2->len) - (key1->len < key2->len);
+
+    return res;
+}
+
+static int arrayStrCompare(const void *element1, const void *element2)
+{
+    if (!element1 || !element2)
+        return (element1 != NULL) - (element2 != NULL);
+
+    return strcmp(element1, element2);
+}
+
+static int arrayUpperBound(Array *array, const void *element,
+                           int (*compareFn)(const void *, const void *))
+{
+    int lo = 0, hi = array->size;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if ((*compareFn)(array->arr[mid], element) <= 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+bool arraySort(Array *array, int (*compareFn)(const void *, const void *))
+{
+    if (array && compareFn) {
+        arrayIntroSort(array->arr, 0, array->size, arraySortDepth(array->size), compareFn);
+        return true;
+    }
+
+    return false;
+}
+
+bool arrayStableSort(Array *array, int (*compareFn)(const void *, const void *))
+{
+    if (array && compareFn) {
+        if (array->size > ARRAY_SORT_THRESHOLD) {
+            void **tmp = malloc(array->size * sizeof(void *));
+            assert(tmp);
+            arrayMergeSort(array->arr, tmp, 0, array->size, compareFn);
+            objectRelease(&tmp);
+        } else {
+            arrayInsertionSort(array->arr, 0, array->size, compareFn);
+        }
+        return true;
+    }
+
+    return false;
+}
+
+int arrayBinarySearch(Array *array, const void *element,
+                      int (*compareFn)(const void *, const void *))
+{
+    if (array && compareFn) {
+        /* The first element which is not less than 'element' */
+        int lo = 0, hi = array->size;
+        while (lo < hi) {
+            int mid = lo + (hi - lo) / 2;
+            if ((*compareFn)(array->arr[mid], element) < 0)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        if (lo < array->size && (*compareFn)(array->arr[lo], element) == 0)
+            return lo;
+    }
+
+    return -1;
+}
+
+int arrayInsertSorted(Array *array, void *element, int (*compareFn)(const void *, const void *))
+{
+    if (array && compareFn) {
+        /* After the equal elements, so the insertion order is kept. */
+        int idx = arrayUpperBound(array, element, compareFn);
+        if (arrayInsertAt(array, idx, element))
+            return idx;
+    }
+
+    return -1;
+}
+
+bool arraySortStr(Array *array)
+{
+    if (array) {
+        int size = array->size;
+        if (size > 1) {
+            /* Every length is computed once, the comparisons use memcmp() only. */
+            ArrayStrKey *keys = malloc(size * sizeof(ArrayStrKey));
+            void **ptrs = malloc(size * sizeof(void *));
+            assert(keys && ptrs);
+            for (int i = 0; i < size; i++) {
+                keys[i].str = array->arr[i];
+                keys[i].len = keys[i].str ? strlen(keys[i].str) : 0;
+                ptrs[i] = &keys[i];
+            }
+            arrayIntroSort(ptrs, 0, size, arraySortDepth(size), arrayStrKeyCompare);
+            for (int i = 0; i < size; i++)
+                array->arr[i] = (void *)((ArrayStrKey *)ptrs[i])->str;
+            objectRelease(&ptrs);
+            objectRelease(&keys);
+        }
+        return true;
+    }
+
+    return false;
+}
+
+int arrayBinarySearchStr(Array *array, const char *str)
+{
+    return arrayBinarySearch(array, str, arrayStrCompare);
+}
+
+int arrayInsertSortedStr(Array *array, char *str)
+{
+    return arrayInsertSorted(array, str, arrayStrCompare);
+}
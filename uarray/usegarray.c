@@ -0,0 +1,129 @@
+/*
+(C) 2021 by Domenico Panella <pandom79@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 3.
+See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
+*/
+
+#include "../ulib.h"
+#include <limits.h>
+
+#define SEG_ARRAY_CHUNK_SIZE (1 << SEG_ARRAY_CHUNK_SHIFT)
+#define SEG_ARRAY_CHUNK_MASK (SEG_ARRAY_CHUNK_SIZE - 1)
+
+static inline char *segArrayElement(SegArray *segArray, int idx)
+{
+    return (char *)segArray->chunks[idx >> SEG_ARRAY_CHUNK_SHIFT] +
+           (size_t)(idx & SEG_ARRAY_CHUNK_MASK) * segArray->elementSize;
+}
+
+static void segArrayAddChunk(SegArray *segArray)
+{
+    if (segArray->numOfChunks == segArray->chunksCapacity) {
+        /* Only the directory is reallocated, the chunks are never moved. */
+        int chunksCapacity = segArray->chunksCapacity * 2;
+        void **chunks = realloc(segArray->chunks, chunksCapacity * sizeof(void *));
+        assert(chunks);
+        segArray->chunks = chunks;
+        segArray->chunksCapacity = chunksCapacity;
+    }
+    void *chunk = malloc((size_t)SEG_ARRAY_CHUNK_SIZE * segArray->elementSize);
+    assert(chunk);
+    segArray->chunks[segArray->numOfChunks++] = chunk;
+}
+
+SegArray *segArrayNew(int elementSize, void (*releaseFn)(void *))
+{
+    assert(elementSize > 0);
+
+    SegArray *segArray = calloc(1, sizeof(SegArray));
+    assert(segArray);
+    segArray->chunksCapacity = 1;
+    segArray->chunks = calloc(1, sizeof(void *));
+    assert(segArray->chunks);
+    segArray->elementSize = elementSize;
+    segArray->releaseFn = releaseFn;
+
+    return segArray;
+}
+
+void segArrayRelease(SegArray **segArray)
+{
+    if (*segArray) {
+        segArrayClear(*segArray);
+        for (int i = 0; i < (*segArray)->numOfChunks; i++)
+            objectRelease(&(*segArray)->chunks[i]);
+        objectRelease(&(*segArray)->chunks);
+        objectRelease(segArray);
+    }
+}
+
+void *segArrayAdd(SegArray *segArray, const void *element)
+{
+    if (segArray && segArray->size < INT_MAX) {
+        /* The chunks kept by segArrayClear() are reused before allocating new ones. */
+        if ((segArray->size >> SEG_ARRAY_CHUNK_SHIFT) == segArray->numOfChunks)
+            segArrayAddChunk(segArray);
+        char *segElement = segArrayElement(segArray, segArray->size++);
+        if (element)
+            memcpy(segElement, element, segArray->elementSize);
+        else
+            memset(segElement, 0, segArray->elementSize);
+        return segElement;
+    }
+
+    return NULL;
+}
+
+void *segArrayGet(SegArray *segArray, int idx)
+{
+    if (segArray && idx >= 0 && idx < segArray->size)
+        return segArrayElement(segArray, idx);
+
+    return NULL;
+}
+
+bool segArrayRemoveLast(SegArray *segArray)
+{
+    if (segArray && segArray->size > 0) {
+        segArray->size--;
+        if (segArray->releaseFn)
+            (*segArray->releaseFn)(segArrayElement(segArray, segArray->size));
+        return true;
+    }
+
+    return false;
+}
+
+void segArrayClear(SegArray *segArray)
+{
+    if (segArray) {
+        if (segArray->releaseFn) {
+            for (int i = 0; i < segArray->size; i++)
+                (*segArray->releaseFn)(segArrayElement(segArray, i));
+        }
+        segArray->size = 0;
+    }
+}
+
+void segArrayIterInit(SegArray *segArray, SegArrayIterator *segArrayIter)
+{
+    if (segArray && segArrayIter) {
+        segArrayIter->segArray = segArray;
+        segArrayIter->idx = 0;
+    }
+}
+
+bool segArrayIterNext(SegArrayIterator *segArrayIter, void **element)
+{
+    if (segArrayIter && segArrayIter->segArray &&
+        segArrayIter->idx < segArrayIter->segArray->size) {
+        if (element)
+            *element = segArrayElement(segArrayIter->segArray, segArrayIter->idx);
+        segArrayIter->idx++;
+        return true;
+    }
+
+    return false;
+}
@@ -8,238 +8,1036 @@ See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
 
 #include "uhashtable.h"
 
-static int hash(int capacity, const char *key)
+/* Number of the keys whose memory is prefetched together by htGetMany() function. */
+#define HT_BATCH_SIZE 16
+
+/* Seed for the hash tables which will be created. */
+static uint64_t HT_HASH_SEED = 0;
+/* Interned keys shared by all the HT_KEY_INTERN hash tables. */
+static Ht *HT_INTERN_POOL = NULL;
+static pthread_mutex_t HT_INTERN_LOCK = PTHREAD_MUTEX_INITIALIZER;
+
+/* HASH (wyhash) */
+
+static const uint64_t HT_SECRET[4] = { 0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull,
+                                       0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull };
+
+static inline void htMum(uint64_t *a, uint64_t *b)
+{
+#ifdef __SIZEOF_INT128__
+    __extension__ typedef unsigned __int128 uint128;
+    uint128 r = *a;
+    r *= *b;
+    *a = (uint64_t)r;
+    *b = (uint64_t)(r >> 64);
+#else
+    uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32), c = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    *a = lo;
+    *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+static inline uint64_t htMix(uint64_t a, uint64_t b)
+{
+    htMum(&a, &b);
+    return a ^ b;
+}
+
+static inline uint64_t htRead8(const uint8_t *p)
+{
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint64_t htRead4(const uint8_t *p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+uint64_t htHash(uint64_t seed, const char *key, size_t len)
 {
-    int bucketIdx = 0, len = 0, factor = 31;
+    const uint8_t *p = (const uint8_t *)key;
+    uint64_t a = 0, b = 0;
+
+    assert(key && len > 0);
+
+    seed ^= htMix(seed ^ HT_SECRET[0], HT_SECRET[1]);
+    if (len <= 16) {
+        if (len >= 4) {
+            a = (htRead4(p) << 32) | htRead4(p + ((len >> 3) << 2));
+            b = (htRead4(p + len - 4) << 32) | htRead4(p + len - 4 - ((len >> 3) << 2));
+        } else {
+            a = ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) | p[len - 1];
+        }
+    } else {
+        size_t i = len;
+        if (i > 48) {
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = htMix(htRead8(p) ^ HT_SECRET[1], htRead8(p + 8) ^ seed);
+                see1 = htMix(htRead8(p + 16) ^ HT_SECRET[2], htRead8(p + 24) ^ see1);
+                see2 = htMix(htRead8(p + 32) ^ HT_SECRET[3], htRead8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = htMix(htRead8(p) ^ HT_SECRET[1], htRead8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = htRead8(p + i - 16);
+        b = htRead8(p + i - 8);
+    }
+    a ^= HT_SECRET[1];
+    b ^= seed;
+    htMum(&a, &b);
+
+    return htMix(a ^ HT_SECRET[0] ^ len, b ^ HT_SECRET[1]);
+}
+
+int htCapacity(int capacity)
+{
+    int htCapacity = 1;
 
     assert(capacity > 0);
-    assert(key && !stringEquals(key, ""));
 
-    len = strlen(key);
-    for (int i = 0; i < len; i++) {
-        bucketIdx = ((bucketIdx % capacity) + (((int)key[i]) * factor) % capacity) % capacity;
-        factor = ((factor % __INT16_MAX__) * (31 % __INT16_MAX__)) % __INT16_MAX__;
+    /* The capacity is a power of 2 so the hash entry index is given by a mask. */
+    while (htCapacity < capacity)
+        htCapacity <<= 1;
+
+    return htCapacity;
+}
+
+static char *htKeyNew(const char *key, size_t len)
+{
+    /* The key could be not null-terminated, the copy is. */
+    char *htKey = malloc(len + 1);
+    assert(htKey);
+    memcpy(htKey, key, len);
+    htKey[len] = '\0';
+
+    return htKey;
+}
+
+static char *htInternAcquire(const char *key, size_t len)
+{
+    pthread_mutex_lock(&HT_INTERN_LOCK);
+    if (!HT_INTERN_POOL) {
+        /* The pool keys are borrowed from the interned keys themselves. */
+        HT_INTERN_POOL = htNewFlat(64, NULL);
+        htSetKeyMode(HT_INTERN_POOL, HT_KEY_BORROW);
+    }
+    HtInternKey *internKey = htGetN(HT_INTERN_POOL, key, len);
+    if (!internKey) {
+        internKey = malloc(sizeof(HtInternKey) + len + 1);
+        assert(internKey);
+        internKey->refs = 0;
+        memcpy(internKey->key, key, len);
+        internKey->key[len] = '\0';
+        htAddN(HT_INTERN_POOL, internKey->key, len, internKey);
     }
+    internKey->refs++;
+    pthread_mutex_unlock(&HT_INTERN_LOCK);
 
-    return bucketIdx;
+    return internKey->key;
+}
+
+static void htInternRelease(char **key, size_t len)
+{
+    HtInternKey *internKey = (HtInternKey *)(*key - offsetof(HtInternKey, key));
+    pthread_mutex_lock(&HT_INTERN_LOCK);
+    if (--internKey->refs == 0) {
+        htRemoveN(HT_INTERN_POOL, internKey->key, len);
+        objectRelease(&internKey);
+        if (HT_INTERN_POOL->numOfItems == 0)
+            htRelease(&HT_INTERN_POOL);
+    }
+    pthread_mutex_unlock(&HT_INTERN_LOCK);
+    *key = NULL;
+}
+
+static char *htKeyAcquire(Ht *ht, const char *key, size_t len)
+{
+    switch (ht->keyMode) {
+    case HT_KEY_BORROW:
+        return (char *)key;
+    case HT_KEY_INTERN:
+        return htInternAcquire(key, len);
+    default:
+        return htKeyNew(key, len);
+    }
+}
+
+static void htKeyRelease(HtKeyMode keyMode, char **key, size_t len)
+{
+    switch (keyMode) {
+    case HT_KEY_BORROW:
+        *key = NULL;
+        break;
+    case HT_KEY_INTERN:
+        htInternRelease(key, len);
+        break;
+    default:
+        objectRelease(key);
+    }
 }
 
-static HtItem *htItemNew(Ht *ht, const char *key, void *value)
+static inline bool htKeyEquals(const char *htKey, unsigned int htKeyLen, const char *key,
+                               size_t len)
 {
-    assert(key && !stringEquals(key, ""));
+    return htKeyLen == len && memcmp(htKey, key, len) == 0;
+}
+
+static void htItemInit(Ht *ht, HtItem *htItem, const char *key, size_t len, uint64_t hash,
+                       void *value)
+{
+    assert(key && len > 0);
     assert(ht);
 
-    HtItem *htItem = calloc(1, sizeof(HtItem));
-    assert(htItem);
-    htItem->key = stringNew(key);
+    htItem->hash = hash;
+    htItem->keyLen = len;
+    /* The short keys are copied into the item itself, saving the key allocation. */
+    htItem->keyInline = ht->keyMode == HT_KEY_COPY && len < HT_KEY_INLINE_SIZE;
+    if (htItem->keyInline) {
+        memcpy(htItem->key.buf, key, len);
+        htItem->key.buf[len] = '\0';
+    } else {
+        htItem->key.ptr = htKeyAcquire(ht, key, len);
+    }
     htItem->value = value;
-    htItem->releaseFn = ht->releaseFn;
+}
 
-    return htItem;
+static void htItemRelease(Ht *ht, HtItem *htItem)
+{
+    if (!htItem->keyInline)
+        htKeyRelease(ht->keyMode, &htItem->key.ptr, htItem->keyLen);
+    if (ht->releaseFn)
+        (*ht->releaseFn)(&htItem->value);
 }
 
-static void htItemRelease(HtItem **htItem)
+/* CHAINED (separate chaining) */
+
+static HtItem *htEntryAdd(HtEntry *htEntry)
 {
-    if (*htItem) {
-        objectRelease(&(*htItem)->key);
-        void (*releaseFn)(void **) = (*htItem)->releaseFn;
-        if (releaseFn)
-            (*releaseFn)(&(*htItem)->value);
-        objectRelease(htItem);
+    /* The chains are short, so the items array grows by doubling from a single item. */
+    if (htEntry->size == htEntry->capacity) {
+        int capacity = htEntry->capacity > 0 ? htEntry->capacity * 2 : 1;
+        HtItem *htItems = realloc(htEntry->htItems, capacity * sizeof(HtItem));
+        assert(htItems);
+        htEntry->htItems = htItems;
+        htEntry->capacity = capacity;
     }
+
+    return &htEntry->htItems[htEntry->size++];
 }
 
-static HtEntry *htEntryNew()
+static void htEntryRemoveAt(HtEntry *htEntry, int itemIdx)
 {
-    HtEntry *htEntry = calloc(1, sizeof(HtEntry));
-    assert(htEntry);
-    htEntry->htItems = arrayNew(htItemRelease);
+    /* The items order is not relevant: the last item takes the place of the removed one. */
+    htEntry->htItems[itemIdx] = htEntry->htItems[--htEntry->size];
+    if (htEntry->size == 0) {
+        objectRelease(&htEntry->htItems);
+        htEntry->capacity = 0;
+    }
+}
 
-    return htEntry;
+static void htEntriesRelease(Ht *ht, HtEntry **htEntries, int capacity)
+{
+    if (*htEntries) {
+        for (int i = 0; i < capacity; i++) {
+            HtEntry *htEntry = &(*htEntries)[i];
+            for (int j = 0; j < htEntry->size; j++)
+                htItemRelease(ht, &htEntry->htItems[j]);
+            objectRelease(&htEntry->htItems);
+        }
+        objectRelease(htEntries);
+    }
 }
 
-static void htEntryRelease(HtEntry **htEntry)
+static HtItem *htEntryFind(HtEntry *htEntry, const char *key, size_t len, uint64_t hash,
+                           int *itemIdx)
 {
-    if (*htEntry) {
-        arrayRelease(&(*htEntry)->htItems);
-        objectRelease(htEntry);
+    HtItem *htItems = htEntry->htItems;
+    int lenHtItems = htEntry->size;
+    for (int i = 0; i < lenHtItems; i++) {
+        HtItem *htItem = &htItems[i];
+        /* The keys are compared only if the hashes are equal. */
+        if (htItem->hash == hash && htKeyEquals(htItemKey(htItem), htItem->keyLen, key, len)) {
+            if (itemIdx)
+                *itemIdx = i;
+            return htItem;
+        }
     }
+
+    return NULL;
 }
 
-Ht *htNew(int initialCapacity, void (*releaseFn)(void **))
+/* FLAT (open addressing with Robin Hood probing) */
+
+static inline bool htFlatIsEmpty(const HtItem *htSlot)
+{
+    return !htSlot->keyLen;
+}
+
+static inline uint64_t htFlatHash(const HtItem *htSlot)
+{
+    return htSlot->hash;
+}
+
+static inline bool htFlatMatch(const HtItem *htSlot, uint64_t hash, const void *key, size_t len)
+{
+    return htSlot->hash == hash && htKeyEquals(htItemKey(htSlot), htSlot->keyLen, key, len);
+}
+
+HT_PROBE_DEFINE(htFlat, HtItem, htFlatIsEmpty, htFlatHash, htFlatMatch)
+
+static inline int htFlatFind(Ht *ht, const char *key, size_t len, uint64_t hash)
+{
+    return htFlatProbe(ht->htSlots, ht->capacity, hash, key, len);
+}
+
+static inline void htFlatRemoveAt(Ht *ht, int idx)
+{
+    htFlatShiftBack(ht->htSlots, ht->capacity, idx);
+}
+
+static void htFlatResize(Ht *ht, int capacity)
+{
+    assert(ht);
+    assert(capacity > 0);
+
+    uint64_t start = htStatsNow();
+    HtItem *oldHtSlots = ht->htSlots;
+    int oldCapacity = ht->capacity;
+    HtItem *htSlots = calloc(capacity, sizeof(HtItem));
+    assert(htSlots);
+    /* Only the slots are moved, the keys are not duplicated. */
+    htFlatMoveAll(htSlots, capacity, oldHtSlots, oldCapacity);
+    objectRelease(&oldHtSlots);
+    ht->htSlots = htSlots;
+    ht->capacity = capacity;
+    ht->version++;
+    HT_STATS_ADD(ht, resizeTime, htStatsNow() - start);
+}
+
+static void htFlatRelease(Ht *ht)
+{
+    HtItem *htSlots = ht->htSlots;
+    for (int i = 0; i < ht->capacity; i++) {
+        if (htSlots[i].keyLen)
+            htItemRelease(ht, &htSlots[i]);
+    }
+    objectRelease(&ht->htSlots);
+}
+
+/* RESIZE */
+
+static void htRehash(Ht *ht, int steps)
+{
+    HtEntry *htOldEntries = ht->htOldEntries;
+    HtEntry *htEntries = ht->htEntries;
+    int mask = ht->capacity - 1;
+    int *rehashIdx = &ht->rehashIdx;
+    uint64_t start = htStatsNow();
+
+    assert(htOldEntries);
+
+    ht->version++;
+
+    for (; steps > 0 && *rehashIdx < ht->oldCapacity; steps--, (*rehashIdx)++) {
+        HtEntry *htEntry = &htOldEntries[*rehashIdx];
+        /* The stored hash is enough to find the new index, the key is not read.
+         * The items are copied as they are, so the keys are neither duplicated nor released.
+        */
+        for (int i = 0; i < htEntry->size; i++)
+            *htEntryAdd(&htEntries[htEntry->htItems[i].hash & mask]) = htEntry->htItems[i];
+        objectRelease(&htEntry->htItems);
+        htEntry->size = htEntry->capacity = 0;
+    }
+    if (*rehashIdx == ht->oldCapacity) {
+        /* All the old hash entries are empty now. */
+        objectRelease(&ht->htOldEntries);
+        ht->oldCapacity = 0;
+        ht->rehashIdx = 0;
+    }
+    HT_STATS_ADD(ht, resizeTime, htStatsNow() - start);
+}
+
+static void htResize(Ht *ht, int capacity, bool incremental)
+{
+    assert(ht);
+    assert(!ht->htOldEntries);
+    assert(capacity > 0);
+
+    HT_STATS_ADD(ht, numOfResizes, 1);
+    if (ht->type == HT_FLAT) {
+        htFlatResize(ht, capacity);
+        return;
+    }
+    /* The hash table structure is not replaced, only its hash entries. */
+    ht->htOldEntries = ht->htEntries;
+    ht->oldCapacity = ht->capacity;
+    ht->rehashIdx = 0;
+    ht->htEntries = calloc(capacity, sizeof(HtEntry));
+    assert(ht->htEntries);
+    ht->capacity = capacity;
+    /* Without the rehash step, all the hash entries are moved now. */
+    htRehash(ht, incremental && ht->rehashStep > 0 ? ht->rehashStep : ht->oldCapacity);
+}
+
+static void htCheckGrow(Ht *ht)
+{
+    if (ht->htOldEntries) {
+        htRehash(ht, ht->rehashStep);
+    } else {
+        if (htPolicyGrow(&ht->policy, ht->capacity, ht->numOfItems))
+            htResize(ht, ht->capacity * 2, true);
+    }
+}
+
+static void htCheckShrink(Ht *ht)
+{
+    if (ht->htOldEntries) {
+        htRehash(ht, ht->rehashStep);
+    } else {
+        if (htPolicyShrink(&ht->policy, ht->capacity, ht->numOfItems))
+            htResize(ht, ht->capacity / 2, true);
+    }
+}
+
+static int htFitCapacity(Ht *ht, int numOfItems)
+{
+    /* The smallest capacity which contains 'numOfItems' items without growing. */
+    int capacity = ht->policy.minCapacity;
+    while (htPolicyGrow(&ht->policy, capacity, numOfItems))
+        capacity <<= 1;
+
+    return capacity;
+}
+
+static void htFlatAddNew(Ht *ht, const char *key, size_t len, uint64_t hash, void *value)
+{
+    HtItem htSlot;
+    htItemInit(ht, &htSlot, key, len, hash, value);
+    htFlatInsert(ht->htSlots, ht->capacity, htSlot);
+    ht->numOfItems++;
+    ht->version++;
+    htCheckGrow(ht);
+}
+
+static bool htFlatAdd(Ht *ht, const char *key, size_t len, uint64_t hash, void *value)
+{
+    if (htFlatFind(ht, key, len, hash) != -1)
+        return false;
+    htFlatAddNew(ht, key, len, hash, value);
+
+    return true;
+}
+
+static bool htFlatRemove(Ht *ht, const char *key, size_t len, uint64_t hash)
+{
+    int idx = htFlatFind(ht, key, len, hash);
+    if (idx == -1)
+        return false;
+    htItemRelease(ht, &((HtItem *)ht->htSlots)[idx]);
+    htFlatRemoveAt(ht, idx);
+    ht->numOfItems--;
+    ht->version++;
+    htCheckShrink(ht);
+
+    return true;
+}
+
+static bool htFlatSet(Ht *ht, const char *key, size_t len, uint64_t hash, void *value)
+{
+    int idx = htFlatFind(ht, key, len, hash);
+    if (idx == -1)
+        return false;
+    HtItem *htSlot = &((HtItem *)ht->htSlots)[idx];
+    if (ht->releaseFn)
+        (*ht->releaseFn)(&htSlot->value);
+    htSlot->value = value;
+
+    return true;
+}
+
+/* HASHED (the key hash is given by the caller) */
+
+static HtEntry *htGetEntry(Ht *ht, uint64_t hash)
+{
+    /* During a rehashing, a key is into the old hash entries if they have not been moved yet. */
+    if (ht->htOldEntries) {
+        int idx = hash & (ht->oldCapacity - 1);
+        if (idx >= ht->rehashIdx)
+            return &((HtEntry *)ht->htOldEntries)[idx];
+    }
+
+    return &((HtEntry *)ht->htEntries)[hash & (ht->capacity - 1)];
+}
+
+static void htEntryAddNew(Ht *ht, HtEntry *htEntry, const char *key, size_t len, uint64_t hash,
+                          void *value)
+{
+    htItemInit(ht, htEntryAdd(htEntry), key, len, hash, value);
+    ht->numOfItems++;
+    ht->version++;
+    htCheckGrow(ht);
+}
+
+HtItem *htFindHashed(Ht *ht, const char *key, size_t len, uint64_t hash)
+{
+    if (ht->type == HT_FLAT) {
+        int idx = htFlatFind(ht, key, len, hash);
+        return idx != -1 ? &((HtItem *)ht->htSlots)[idx] : NULL;
+    }
+
+    return htEntryFind(htGetEntry(ht, hash), key, len, hash, NULL);
+}
+
+void *htGetHashed(Ht *ht, const char *key, size_t len, uint64_t hash)
+{
+    HtItem *htItem = htFindHashed(ht, key, len, hash);
+    if (htItem) {
+        HT_STATS_ADD(ht, hits, 1);
+        return htItem->value;
+    }
+    HT_STATS_ADD(ht, misses, 1);
+
+    return NULL;
+}
+
+bool htAddHashed(Ht *ht, const char *key, size_t len, uint64_t hash, void *value)
+{
+    if (ht->type == HT_FLAT)
+        return htFlatAdd(ht, key, len, hash, value);
+    HtEntry *htEntry = htGetEntry(ht, hash);
+    if (htEntryFind(htEntry, key, len, hash, NULL))
+        return false;
+    htEntryAddNew(ht, htEntry, key, len, hash, value);
+
+    return true;
+}
+
+void *htGetOrAddHashed(Ht *ht, const char *key, size_t len, uint64_t hash, void *value,
+                       bool *added)
+{
+    /* A single lookup decides between the existing value and the addition. */
+    if (ht->type == HT_FLAT) {
+        int idx = htFlatFind(ht, key, len, hash);
+        if (idx != -1) {
+            *added = false;
+            return ((HtItem *)ht->htSlots)[idx].value;
+        }
+        htFlatAddNew(ht, key, len, hash, value);
+    } else {
+        HtEntry *htEntry = htGetEntry(ht, hash);
+        HtItem *htItem = htEntryFind(htEntry, key, len, hash, NULL);
+        if (htItem) {
+            *added = false;
+            return htItem->value;
+        }
+        htEntryAddNew(ht, htEntry, key, len, hash, value);
+    }
+    *added = true;
+
+    return value;
+}
+
+bool htRemoveHashed(Ht *ht, const char *key, size_t len, uint64_t hash)
+{
+    if (ht->type == HT_FLAT)
+        return htFlatRemove(ht, key, len, hash);
+    int itemIdx = -1;
+    HtEntry *htEntry = htGetEntry(ht, hash);
+    HtItem *htItem = htEntryFind(htEntry, key, len, hash, &itemIdx);
+    if (htItem) {
+        htItemRelease(ht, htItem);
+        htEntryRemoveAt(htEntry, itemIdx);
+        ht->numOfItems--;
+        ht->version++;
+        htCheckShrink(ht);
+        return true;
+    }
+
+    return false;
+}
+
+bool htSetHashed(Ht *ht, const char *key, size_t len, uint64_t hash, void *value)
+{
+    if (ht->type == HT_FLAT)
+        return htFlatSet(ht, key, len, hash, value);
+    HtItem *htItem = htEntryFind(htGetEntry(ht, hash), key, len, hash, NULL);
+    if (htItem) {
+        if (ht->releaseFn)
+            (*ht->releaseFn)(&htItem->value);
+        htItem->value = value;
+        return true;
+    }
+
+    return false;
+}
+
+static void htItemCopy(Ht *ht, HtItem *htItem)
+{
+    /* The inline keys are copied with the item, the others are acquired again. */
+    if (!htItem->keyInline)
+        htItem->key.ptr = htKeyAcquire(ht, htItem->key.ptr, htItem->keyLen);
+}
+
+Ht *htClone(Ht *ht)
+{
+    Ht *htClone = malloc(sizeof(Ht));
+    assert(htClone);
+    /* The lookups of the source could be updating its counters concurrently. */
+    memcpy(htClone, ht, offsetof(Ht, counters));
+    htClone->counters.hits = __atomic_load_n(&ht->counters.hits, __ATOMIC_RELAXED);
+    htClone->counters.misses = __atomic_load_n(&ht->counters.misses, __ATOMIC_RELAXED);
+    htClone->counters.numOfResizes = ht->counters.numOfResizes;
+    htClone->counters.resizeTime = ht->counters.resizeTime;
+    int capacity = ht->capacity;
+    if (ht->type == HT_FLAT) {
+        /* The same capacity gives the same slots layout. */
+        HtItem *htSlots = malloc(capacity * sizeof(HtItem));
+        assert(htSlots);
+        memcpy(htSlots, ht->htSlots, capacity * sizeof(HtItem));
+        for (int i = 0; i < capacity; i++) {
+            if (htSlots[i].keyLen)
+                htItemCopy(htClone, &htSlots[i]);
+        }
+        htClone->htSlots = htSlots;
+        return htClone;
+    }
+    /* As for the rehashing, the stored hash gives the hash entry of the clone.
+     * A rehashing in progress is completed into the clone, the source is never modified.
+    */
+    HtEntry *htEntries = calloc(capacity, sizeof(HtEntry));
+    assert(htEntries);
+    HtEntry *htEntriesArr[2] = { ht->htOldEntries, ht->htEntries };
+    int capacities[2] = { ht->htOldEntries ? ht->oldCapacity : 0, capacity };
+    for (int j = 0; j < 2; j++) {
+        for (int i = 0; i < capacities[j]; i++) {
+            HtEntry *htEntry = &htEntriesArr[j][i];
+            for (int k = 0; k < htEntry->size; k++) {
+                HtItem *htItem = htEntryAdd(&htEntries[htEntry->htItems[k].hash & (capacity - 1)]);
+                *htItem = htEntry->htItems[k];
+                htItemCopy(htClone, htItem);
+            }
+        }
+    }
+    htClone->htEntries = htEntries;
+    htClone->htOldEntries = NULL;
+    htClone->oldCapacity = 0;
+    htClone->rehashIdx = 0;
+
+    return htClone;
+}
+
+/* PUBLIC */
+
+void htSetHashSeed(uint64_t seed)
+{
+    HT_HASH_SEED = seed;
+}
+
+uint64_t htHashSeed(void)
+{
+    return HT_HASH_SEED;
+}
+
+bool htPolicyValid(const HtPolicy *policy, bool flat)
+{
+    if (!policy)
+        return true;
+
+    /* The negated comparisons reject NaN as well, 2^30 is the largest int power of 2. */
+    if (!(policy->growLoadFactor > 0) || policy->minCapacity < 0 ||
+        policy->minCapacity > (1 << 30))
+        return false;
+    /* An open addressing table must always contain an empty slot. */
+    if (flat && !(policy->growLoadFactor < 1))
+        return false;
+    /* Hysteresis: after a resize, the load factor must be far from both the thresholds. */
+    return policy->shrinkDisabled ||
+           (policy->shrinkLoadFactor >= 0 &&
+            policy->shrinkLoadFactor * 2 < policy->growLoadFactor);
+}
+
+void htPolicyInit(HtPolicy *htPolicy, const HtPolicy *policy, int initialCapacity)
+{
+    if (policy) {
+        *htPolicy = *policy;
+    } else {
+        memset(htPolicy, 0, sizeof(HtPolicy));
+        htPolicy->growLoadFactor = 0.75;
+        htPolicy->shrinkLoadFactor = 0.25;
+        htPolicy->shrinkDisabled = false;
+    }
+    htPolicy->minCapacity = htPolicy->minCapacity > 0 ? htCapacity(htPolicy->minCapacity) :
+                                                        initialCapacity;
+}
+
+Ht *htNewWithPolicy(HtType type, int initialCapacity, void (*releaseFn)(void **),
+                    const HtPolicy *policy)
 {
     assert(initialCapacity > 0);
 
+    if (!htPolicyValid(policy, type == HT_FLAT))
+        return NULL;
+
     Ht *ht = calloc(1, sizeof(Ht));
     assert(ht);
+    ht->type = type;
     ht->numOfItems = 0;
-    ht->initialCapacity = initialCapacity;
-    ht->capacity = initialCapacity;
+    ht->initialCapacity = htCapacity(initialCapacity);
+    ht->capacity = ht->initialCapacity;
+    ht->seed = HT_HASH_SEED;
     ht->releaseFn = releaseFn;
-    ht->htEntries = arrayNewWithAmount(initialCapacity, htEntryRelease);
+    ht->keyMode = HT_KEY_COPY;
+    /* Policy */
+    htPolicyInit(&ht->policy, policy, ht->initialCapacity);
+    if (ht->capacity < ht->policy.minCapacity)
+        ht->capacity = ht->policy.minCapacity;
+    /* Hash entries */
+    if (type == HT_FLAT) {
+        ht->htSlots = calloc(ht->capacity, sizeof(HtItem));
+        assert(ht->htSlots);
+    } else {
+        ht->htEntries = calloc(ht->capacity, sizeof(HtEntry));
+        assert(ht->htEntries);
+    }
     ht->totCollisions = -1;
     ht->maxCollisionsForEntry = -1;
 
     return ht;
 }
 
+Ht *htNew(int initialCapacity, void (*releaseFn)(void **))
+{
+    return htNewWithPolicy(HT_CHAINED, initialCapacity, releaseFn, NULL);
+}
+
+Ht *htNewFlat(int initialCapacity, void (*releaseFn)(void **))
+{
+    return htNewWithPolicy(HT_FLAT, initialCapacity, releaseFn, NULL);
+}
+
+Ht *htNewFromArrays(HtType type, const char **keys, void **values, int numOfItems,
+                    void (*releaseFn)(void **), const HtPolicy *policy, bool checkDup)
+{
+    assert(keys && values);
+    assert(numOfItems >= 0);
+
+    /* As htAdd() function, the null or empty keys are rejected. */
+    for (int i = 0; i < numOfItems; i++) {
+        if (!keys[i] || !keys[i][0])
+            return NULL;
+    }
+    Ht *ht = htNewWithPolicy(type, numOfItems > 0 ? numOfItems : 1, releaseFn, policy);
+    if (!ht)
+        return NULL;
+    /* The final capacity is allocated at once, no resize will happen. */
+    htReserve(ht, numOfItems);
+    int mask = ht->capacity - 1;
+    uint64_t *hashes = malloc((numOfItems + 1) * sizeof(uint64_t));
+    assert(hashes);
+    for (int i = 0; i < numOfItems; i++)
+        hashes[i] = htHash(ht->seed, keys[i], strlen(keys[i]));
+    bool dup = false;
+    if (type == HT_FLAT) {
+        for (int i = 0; i < numOfItems && !dup; i++) {
+            size_t len = strlen(keys[i]);
+            dup = checkDup && htFlatFind(ht, keys[i], len, hashes[i]) != -1;
+            if (!dup) {
+                HtItem htSlot;
+                htItemInit(ht, &htSlot, keys[i], len, hashes[i], values[i]);
+                htFlatInsert(ht->htSlots, ht->capacity, htSlot);
+                ht->numOfItems++;
+            }
+        }
+    } else {
+        /* Every hash entry is allocated once with the exact number of its items. */
+        HtEntry *htEntries = ht->htEntries;
+        for (int i = 0; i < numOfItems; i++)
+            htEntries[hashes[i] & mask].capacity++;
+        for (int i = 0; i <= mask; i++) {
+            if (htEntries[i].capacity > 0) {
+                htEntries[i].htItems = malloc(htEntries[i].capacity * sizeof(HtItem));
+                assert(htEntries[i].htItems);
+            }
+        }
+        for (int i = 0; i < numOfItems && !dup; i++) {
+            size_t len = strlen(keys[i]);
+            HtEntry *htEntry = &htEntries[hashes[i] & mask];
+            dup = checkDup && htEntryFind(htEntry, keys[i], len, hashes[i], NULL);
+            if (!dup) {
+                htItemInit(ht, htEntryAdd(htEntry), keys[i], len, hashes[i], values[i]);
+                ht->numOfItems++;
+            }
+        }
+    }
+    objectRelease(&hashes);
+    if (dup) {
+        /* The values are still owned by the caller. */
+        ht->releaseFn = NULL;
+        htRelease(&ht);
+    }
+
+    return ht;
+}
+
 void htRelease(Ht **ht)
 {
     if (*ht) {
-        arrayRelease(&(*ht)->htEntries);
+        if ((*ht)->type == HT_FLAT) {
+            htFlatRelease(*ht);
+        } else {
+            htEntriesRelease(*ht, (HtEntry **)&(*ht)->htEntries, (*ht)->capacity);
+            htEntriesRelease(*ht, (HtEntry **)&(*ht)->htOldEntries, (*ht)->oldCapacity);
+        }
         objectRelease(ht);
     }
 }
 
-static void htResize(Ht **ht, int capacity, void (*releaseFn)(void **))
+void *htGetN(Ht *ht, const char *key, size_t len)
 {
-    assert(*ht);
-    assert(capacity > 0);
+    if (ht && key && len > 0)
+        return htGetHashed(ht, key, len, htHash(ht->seed, key, len));
+
+    return NULL;
+}
+
+void *htGet(Ht *ht, const char *key)
+{
+    return key ? htGetN(ht, key, strlen(key)) : NULL;
+}
+
+int htGetMany(Ht *ht, const char **keys, int numOfKeys, void **values)
+{
+    uint64_t hashes[HT_BATCH_SIZE];
+    size_t lens[HT_BATCH_SIZE];
+    int found = 0;
 
-    Ht *newHt = htNew(capacity, releaseFn);
-    newHt->initialCapacity = (*ht)->initialCapacity;
-    Array *htEntries = (*ht)->htEntries;
-    int lenHtEntries = htEntries->size;
-    for (int i = 0; i < lenHtEntries; i++) {
-        HtEntry *htEntry = arrayGet(htEntries, i);
-        if (htEntry) {
-            Array *htItems = htEntry->htItems;
-            int lenHtItems = htItems->size;
-            Array *newHtEntries = newHt->htEntries;
-            for (int i = 0; i < lenHtItems; i++) {
-                HtItem *htItem = arrayGet(htItems, i);
-                /* Key's rehashing according the new capacity. */
-                int idx = hash(capacity, htItem->key);
-                HtEntry *newHtEntry = arrayGet(newHtEntries, idx);
-                if (!newHtEntry) {
-                    newHtEntry = htEntryNew();
-                    arraySet(newHtEntries, newHtEntry, idx);
+    if (ht && keys && values) {
+        for (int start = 0; start < numOfKeys; start += HT_BATCH_SIZE) {
+            int size = numOfKeys - start < HT_BATCH_SIZE ? numOfKeys - start : HT_BATCH_SIZE;
+            const char **batchKeys = &keys[start];
+            /* The memory of every key is requested before probing the first one. */
+            for (int i = 0; i < size; i++) {
+                lens[i] = batchKeys[i] ? strlen(batchKeys[i]) : 0;
+                if (lens[i] > 0) {
+                    hashes[i] = htHash(ht->seed, batchKeys[i], lens[i]);
+                    if (ht->type == HT_FLAT)
+                        __builtin_prefetch(&((HtItem *)ht->htSlots)[hashes[i] & (ht->capacity - 1)]);
+                    else
+                        __builtin_prefetch(htGetEntry(ht, hashes[i]));
                 }
-                arrayAdd(newHtEntry->htItems, htItem);
-                newHt->numOfItems++;
             }
-            /* We cannot use arrayRemove() function because it decreases
-             * the size of the array losing some hash indexes.
-             * Moreover, if a release function pointer is set, we lose the items inside
-             * which must be added to the new hashtable now.
-            */
-            objectRelease(&htEntry->htItems->arr);
-            objectRelease(&htEntry->htItems);
-            objectRelease(&htEntry);
+            if (ht->type == HT_CHAINED) {
+                for (int i = 0; i < size; i++) {
+                    if (lens[i] > 0)
+                        __builtin_prefetch(htGetEntry(ht, hashes[i])->htItems);
+                }
+            }
+            for (int i = 0; i < size; i++) {
+                HtItem *htItem = lens[i] > 0 ?
+                                     htFindHashed(ht, batchKeys[i], lens[i], hashes[i]) :
+                                     NULL;
+                values[start + i] = htItem ? htItem->value : NULL;
+                if (htItem)
+                    found++;
+                else
+                    HT_STATS_ADD(ht, misses, 1);
+            }
         }
+        HT_STATS_ADD(ht, hits, found);
     }
-    /* We cannot use htRelease() function due to same reasons. */
-    objectRelease(&(*ht)->htEntries->arr);
-    objectRelease(&(*ht)->htEntries);
-    objectRelease(&(*ht));
-    *ht = newHt;
+
+    return found;
 }
 
-void *htGet(Ht *ht, const char *key)
+bool htAddN(Ht *ht, const char *key, size_t len, void *value)
 {
-    if (ht && key && !stringEquals(key, "")) {
-        int idx = hash(ht->capacity, key);
-        HtEntry *htEntry = arrayGet(ht->htEntries, idx);
-        if (htEntry) {
-            Array *htItems = htEntry->htItems;
-            int lenHtItems = htItems->size;
-            for (int i = 0; i < lenHtItems; i++) {
-                HtItem *htItem = arrayGet(htItems, i);
-                if (stringEquals(htItem->key, key))
-                    return htItem->value;
-            }
-        }
+    if (ht && key && len > 0)
+        return htAddHashed(ht, key, len, htHash(ht->seed, key, len), value);
+
+    return false;
+}
+
+bool htAdd(Ht *ht, const char *key, void *value)
+{
+    return key ? htAddN(ht, key, strlen(key), value) : false;
+}
+
+void *htGetOrAddN(Ht *ht, const char *key, size_t len, void *value, bool *added)
+{
+    bool htAdded = false;
+    void *htValue = NULL;
+
+    if (ht && key && len > 0)
+        htValue = htGetOrAddHashed(ht, key, len, htHash(ht->seed, key, len), value, &htAdded);
+    if (added)
+        *added = htAdded;
+
+    return htValue;
+}
+
+void *htGetOrAdd(Ht *ht, const char *key, void *value, bool *added)
+{
+    return htGetOrAddN(ht, key, key ? strlen(key) : 0, value, added);
+}
+
+bool htRemoveN(Ht *ht, const char *key, size_t len)
+{
+    if (ht && key && len > 0)
+        return htRemoveHashed(ht, key, len, htHash(ht->seed, key, len));
+
+    return false;
+}
+
+bool htRemove(Ht *ht, const char *key)
+{
+    return key ? htRemoveN(ht, key, strlen(key)) : false;
+}
+
+bool htSetN(Ht *ht, const char *key, size_t len, void *value)
+{
+    if (ht && key && len > 0)
+        return htSetHashed(ht, key, len, htHash(ht->seed, key, len), value);
+
+    return false;
+}
+
+bool htSet(Ht *ht, const char *key, void *value)
+{
+    return key ? htSetN(ht, key, strlen(key), value) : false;
+}
+
+bool htSetKeyMode(Ht *ht, HtKeyMode keyMode)
+{
+    /* The items already added would have a different key mode. */
+    if (ht && ht->numOfItems == 0) {
+        ht->keyMode = keyMode;
+        return true;
     }
 
-    return NULL;
+    return false;
 }
 
-bool htAdd(Ht **ht, const char *key, void *value)
+bool htSetRehashStep(Ht *ht, int rehashStep)
 {
-    if (*ht && key && !stringEquals(key, "")) {
-        int *capacity = &(*ht)->capacity;
-        int idx = hash(*capacity, key);
-        HtEntry *htEntry = arrayGet((*ht)->htEntries, idx);
-        if (htEntry) {
-            Array *htItems = htEntry->htItems;
-            int lenHtItems = htItems->size;
-            for (int i = 0; i < lenHtItems; i++) {
-                HtItem *htItem = arrayGet(htItems, i);
-                if (stringEquals(htItem->key, key))
-                    return false;
-            }
-        }
-        if (!htEntry) {
-            htEntry = htEntryNew();
-            arraySet((*ht)->htEntries, htEntry, idx);
-        }
-        arrayAdd(htEntry->htItems, htItemNew(*ht, key, value));
-        (*ht)->numOfItems++;
-        /* Check threshold */
-        int threshold = *capacity * 3 / 4;
-        if ((*ht)->numOfItems >= threshold)
-            htResize(ht, *capacity * 2, (*ht)->releaseFn);
+    if (ht && ht->type == HT_CHAINED && rehashStep >= 0) {
+        ht->rehashStep = rehashStep;
+        /* Complete an eventual rehashing in progress */
+        if (rehashStep == 0 && ht->htOldEntries)
+            htRehash(ht, ht->oldCapacity);
         return true;
     }
 
     return false;
 }
 
-bool htRemove(Ht **ht, const char *key)
-{
-    if (*ht && key && !stringEquals(key, "")) {
-        int *capacity = &(*ht)->capacity;
-        int idx = hash(*capacity, key);
-        Array *htEntries = (*ht)->htEntries;
-        HtEntry *htEntry = arrayGet(htEntries, idx);
-        if (htEntry) {
-            Array **htItems = &htEntry->htItems;
-            int lenHtItems = (*htItems)->size;
-            for (int i = 0; i < lenHtItems; i++) {
-                HtItem *htItem = arrayGet(*htItems, i);
-                if (stringEquals(htItem->key, key)) {
-                    if (lenHtItems == 1)
-                        arraySet(htEntries, NULL, idx);
-                    else
-                        arrayRemove(*htItems, htItem);
-                    (*ht)->numOfItems--;
-                    /* Check threshold */
-                    if (*capacity > (*ht)->initialCapacity) {
-                        int threshold = *capacity / 4;
-                        if ((*ht)->numOfItems <= threshold)
-                            htResize(ht, *capacity / 2, (*ht)->releaseFn);
-                    }
-                    return true;
-                }
-            }
-        }
+static void htResizeNow(Ht *ht, int capacity)
+{
+    /* Complete an eventual rehashing in progress before starting a new one. */
+    if (ht->htOldEntries)
+        htRehash(ht, ht->oldCapacity);
+    if (capacity != ht->capacity)
+        htResize(ht, capacity, false);
+}
+
+bool htReserve(Ht *ht, int numOfItems)
+{
+    if (ht && numOfItems >= 0) {
+        int capacity = htFitCapacity(ht, numOfItems);
+        if (capacity > ht->capacity)
+            htResizeNow(ht, capacity);
+        return true;
     }
 
     return false;
 }
 
-bool htSet(Ht **ht, const char *key, void *value)
-{
-    if (*ht && key && !stringEquals(key, "")) {
-        int idx = hash((*ht)->capacity, key);
-        HtEntry *htEntry = arrayGet((*ht)->htEntries, idx);
-        if (htEntry) {
-            Array **htItems = &htEntry->htItems;
-            int lenHtItems = (*htItems)->size;
-            for (int i = 0; i < lenHtItems; i++) {
-                HtItem *htItem = arrayGet(*htItems, i);
-                if (stringEquals(htItem->key, key)) {
-                    void (*releaseFn)(void **) = htItem->releaseFn;
-                    if (releaseFn)
-                        (*releaseFn)(&htItem->value);
-                    htItem->value = value;
-                    return true;
-                }
+bool htShrinkToFit(Ht *ht)
+{
+    if (ht) {
+        int capacity = htFitCapacity(ht, ht->numOfItems);
+        if (capacity < ht->capacity)
+            htResizeNow(ht, capacity);
+        return true;
+    }
+
+    return false;
+}
+
+static int htIterStartIdx(Ht *ht)
+{
+    /* The backward shift deletion never moves an item across an empty slot. */
+    if (ht->type == HT_FLAT) {
+        HtItem *htSlots = ht->htSlots;
+        for (int i = 0; i < ht->capacity; i++) {
+            if (!htSlots[i].keyLen)
+                return (i + 1) & (ht->capacity - 1);
+        }
+    }
+
+    return 0;
+}
+
+static void htIterShrink(Ht *ht)
+{
+    /* The shrinks deferred by the removals during the iteration are performed at once. */
+    int capacity = ht->capacity;
+    while (htPolicyShrink(&ht->policy, capacity, ht->numOfItems))
+        capacity /= 2;
+    if (capacity < ht->capacity)
+        htResizeNow(ht, capacity);
+}
+
+static HtItem *htIterItem(HtIterator *htIterator)
+{
+    Ht *ht = htIterator->ht;
+    int *hashIdx = &htIterator->hashIdx;
+    int *hashItemIdx = &htIterator->hashItemIdx;
+    int capacity = ht->capacity;
+
+    if (ht->type == HT_FLAT) {
+        /* A flat hash entry contains at most one item. */
+        HtItem *htSlots = ht->htSlots;
+        int mask = capacity - 1;
+        for (; *hashIdx < capacity; (*hashIdx)++) {
+            HtItem *htSlot = &htSlots[(htIterator->startIdx + *hashIdx) & mask];
+            if (*hashItemIdx == -1 && htSlot->keyLen) {
+                *hashItemIdx = 0;
+                return htSlot;
             }
+            *hashItemIdx = -1;
         }
+        return NULL;
+    }
+    /* During a rehashing, the old hash entries are visited before the new ones. */
+    HtEntry *htOldEntries = ht->htOldEntries;
+    int oldCapacity = htOldEntries ? ht->oldCapacity : 0;
+    capacity += oldCapacity;
+    for (; *hashIdx < capacity; (*hashIdx)++) {
+        HtEntry *htEntry = *hashIdx < oldCapacity ?
+                               &htOldEntries[*hashIdx] :
+                               &((HtEntry *)ht->htEntries)[*hashIdx - oldCapacity];
+        if (++(*hashItemIdx) < htEntry->size)
+            return &htEntry->htItems[*hashItemIdx];
+        else
+            *hashItemIdx = -1;
     }
 
-    return false;
+    return NULL;
 }
 
 HtIterator *htGetIterator(Ht *ht)
@@ -247,63 +1045,188 @@ HtIterator *htGetIterator(Ht *ht)
     if (ht) {
         HtIterator *htIter = calloc(1, sizeof(HtIterator));
         assert(htIter);
-        htIter->ht = ht;
-        htIter->hashIdx = 0;
-        htIter->hashItemIdx = -1;
+        htIterInit(ht, htIter);
         return htIter;
     }
 
     return NULL;
 }
 
-void *htGetNext(HtIterator *htIterator)
+bool htIterNext(HtIterator *htIterator, const char **key, void **value)
 {
-    if (htIterator) {
+    /* The hash table must not be modified after the iterator creation. */
+    if (htIterator && htIterator->ht && htIterator->version == htIterator->ht->version) {
         Ht *ht = htIterator->ht;
-        int capacity = ht->capacity;
-        int *hashIdx = &htIterator->hashIdx;
-        for (; *hashIdx < capacity; (*hashIdx)++) {
-            HtEntry *htEntry = arrayGet(ht->htEntries, *hashIdx);
-            if (htEntry) {
-                Array *htItems = htEntry->htItems;
-                int *hashItemIdx = &htIterator->hashItemIdx;
-                if (++(*hashItemIdx) < htItems->size)
-                    return ((HtItem *)arrayGet(htItems, *hashItemIdx))->value;
-                else
-                    *hashItemIdx = -1;
-            }
+        HtItem *htItem = htIterItem(htIterator);
+        htIterator->current = htItem != NULL;
+        if (htItem) {
+            if (key)
+                *key = htItemKey(htItem);
+            if (value)
+                *value = htItem->value;
+            return true;
+        }
+        if (htIterator->removed) {
+            htIterator->removed = false;
+            htIterShrink(ht);
+            htIterator->version = ht->version;
         }
     }
 
-    return NULL;
+    return false;
+}
+
+bool htIterRemove(HtIterator *htIterator)
+{
+    if (htIterator && htIterator->ht && htIterator->version == htIterator->ht->version &&
+        htIterator->current) {
+        Ht *ht = htIterator->ht;
+        int hashIdx = htIterator->hashIdx;
+        if (ht->type == HT_FLAT) {
+            int idx = (htIterator->startIdx + hashIdx) & (ht->capacity - 1);
+            htItemRelease(ht, &((HtItem *)ht->htSlots)[idx]);
+            htFlatRemoveAt(ht, idx);
+            /* The slot is visited again: the following item could have been moved into it. */
+            htIterator->hashItemIdx = -1;
+        } else {
+            int oldCapacity = ht->htOldEntries ? ht->oldCapacity : 0;
+            HtEntry *htEntry = hashIdx < oldCapacity ?
+                                   &((HtEntry *)ht->htOldEntries)[hashIdx] :
+                                   &((HtEntry *)ht->htEntries)[hashIdx - oldCapacity];
+            htItemRelease(ht, &htEntry->htItems[htIterator->hashItemIdx]);
+            /* The item index is visited again: the last item has been moved into it. */
+            htEntryRemoveAt(htEntry, htIterator->hashItemIdx--);
+        }
+        /* Neither shrink nor rehashing step: the hash entries must not move. */
+        ht->numOfItems--;
+        ht->version++;
+        htIterator->version = ht->version;
+        htIterator->removed = true;
+        htIterator->current = false;
+        return true;
+    }
+
+    return false;
+}
+
+void *htGetNext(HtIterator *htIterator)
+{
+    void *value = NULL;
+
+    return htIterNext(htIterator, NULL, &value) ? value : NULL;
 }
 
 void htIteratorReset(Ht *ht, HtIterator *htIterator)
+{
+    htIterInit(ht, htIterator);
+}
+
+void htIterInit(Ht *ht, HtIterator *htIterator)
 {
     if (htIterator && ht) {
         htIterator->ht = ht;
         htIterator->hashIdx = 0;
         htIterator->hashItemIdx = -1;
+        htIterator->version = ht->version;
+        htIterator->startIdx = htIterStartIdx(ht);
+        htIterator->removed = false;
+        htIterator->current = false;
     }
 }
 
 void htSetDebugData(Ht *ht)
 {
-    if (ht) {
-        Array *htEntries = ht->htEntries;
+    if (ht && ht->type == HT_FLAT) {
+        /* For a flat hash table, a collision is an item which is not stored into its home slot. */
+        HtItem *htSlots = ht->htSlots;
+        int mask = ht->capacity - 1, totCollisions = 0, maxCollisionsForEntry = 0;
+        for (int i = 0; i < ht->capacity; i++) {
+            if (htSlots[i].keyLen) {
+                int dist = htProbeDist(i, htSlots[i].hash, mask);
+                if (dist > 0)
+                    totCollisions++;
+                if (dist > maxCollisionsForEntry)
+                    maxCollisionsForEntry = dist;
+            }
+        }
+        ht->totCollisions = totCollisions;
+        ht->maxCollisionsForEntry = maxCollisionsForEntry;
+    } else if (ht) {
+        HtEntry *htEntriesArr[2] = { ht->htEntries, ht->htOldEntries };
+        int capacities[2] = { ht->capacity, ht->oldCapacity };
         int collisions = 0, totCollisions = 0, maxCollisionsForEntry = 0, size;
-        size = htEntries ? htEntries->size : 0;
-        for (int i = 0; i < size; i++) {
-            HtEntry *htEntry = arrayGet(htEntries, i);
-            if (htEntry) {
-                int lenHtItems = htEntry->htItems->size;
-                collisions = lenHtItems - 1;
-                totCollisions += collisions;
-                if (collisions > maxCollisionsForEntry)
-                    maxCollisionsForEntry = collisions;
+        for (int j = 0; j < 2; j++) {
+            HtEntry *htEntries = htEntriesArr[j];
+            size = htEntries ? capacities[j] : 0;
+            for (int i = 0; i < size; i++) {
+                HtEntry *htEntry = &htEntries[i];
+                if (htEntry->size > 0) {
+                    collisions = htEntry->size - 1;
+                    totCollisions += collisions;
+                    if (collisions > maxCollisionsForEntry)
+                        maxCollisionsForEntry = collisions;
+                }
             }
         }
         ht->totCollisions = totCollisions;
         ht->maxCollisionsForEntry = maxCollisionsForEntry;
     }
 }
+
+static void htStatsAddItem(Ht *ht, HtStats *htStats, HtItem *htItem, int probeLength)
+{
+    int bucket = probeLength < HT_STATS_HISTOGRAM_SIZE ? probeLength : HT_STATS_HISTOGRAM_SIZE - 1;
+    htStats->probeHistogram[bucket]++;
+    htStats->avgProbeLength += probeLength;
+    if (probeLength > htStats->maxProbeLength)
+        htStats->maxProbeLength = probeLength;
+    if (!htItem->keyInline && ht->keyMode == HT_KEY_COPY)
+        htStats->keyBytes += htItem->keyLen + 1;
+}
+
+bool htGetStats(Ht *ht, HtStats *htStats)
+{
+    if (ht && htStats) {
+        memset(htStats, 0, sizeof(HtStats));
+        htStats->numOfItems = ht->numOfItems;
+        htStats->capacity = ht->capacity;
+        htStats->loadFactor = (float)ht->numOfItems / ht->capacity;
+        if (ht->type == HT_FLAT) {
+            HtItem *htSlots = ht->htSlots;
+            htStats->bucketBytes = ht->capacity * sizeof(HtItem);
+            for (int i = 0; i < ht->capacity; i++) {
+                if (htSlots[i].keyLen)
+                    htStatsAddItem(ht, htStats, &htSlots[i],
+                                   htProbeDist(i, htSlots[i].hash, ht->capacity - 1));
+            }
+        } else {
+            HtEntry *htEntriesArr[2] = { ht->htEntries, ht->htOldEntries };
+            int capacities[2] = { ht->capacity, ht->htOldEntries ? ht->oldCapacity : 0 };
+            for (int j = 0; j < 2; j++) {
+                htStats->bucketBytes += capacities[j] * sizeof(HtEntry);
+                for (int i = 0; i < capacities[j]; i++) {
+                    HtEntry *htEntry = &htEntriesArr[j][i];
+                    htStats->itemBytes += htEntry->capacity * sizeof(HtItem);
+                    for (int k = 0; k < htEntry->size; k++)
+                        htStatsAddItem(ht, htStats, &htEntry->htItems[k], k);
+                }
+            }
+        }
+        if (ht->numOfItems > 0)
+            htStats->avgProbeLength /= ht->numOfItems;
+        /* The counters could be updated by concurrent lookups. */
+        htStats->counters.hits = __atomic_load_n(&ht->counters.hits, __ATOMIC_RELAXED);
+        htStats->counters.misses = __atomic_load_n(&ht->counters.misses, __ATOMIC_RELAXED);
+        htStats->counters.numOfResizes = ht->counters.numOfResizes;
+        htStats->counters.resizeTime = ht->counters.resizeTime;
+        return true;
+    }
+
+    return false;
+}
+
+void htResetCounters(Ht *ht)
+{
+    if (ht)
+        memset(&ht->counters, 0, sizeof(HtCounters));
+}
@@ -10,29 +10,348 @@ See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
 #define UHASHTABLE_H
 
 #include "../ulib.h"
+#include <pthread.h>
+
+#define HT_CACHE_LINE_SIZE 64
+/* _Alignas is C11, the older standards use the equivalent GCC attribute. */
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#define HT_CACHE_ALIGNED _Alignas(HT_CACHE_LINE_SIZE)
+#else
+#define HT_CACHE_ALIGNED __attribute__((aligned(HT_CACHE_LINE_SIZE)))
+#endif
+
+/* The keys shorter than this size are stored into the item itself (null-terminated). */
+#define HT_KEY_INLINE_SIZE 16
+
+/** @struct HtItem
+ *  @brief This structure represents an hash item.<br>
+ *  The items are stored by value into the hash entries (HT_CHAINED) or into the slots (HT_FLAT),<br>
+ *  thus they are moved by the resizes.<br>
+ *  The release function and the key mode are the ones of the hash table.
+ *  @var HtItem::hash
+ *  It represents the 64 bit hash of the key.
+ *  @var HtItem::key
+ *  It represents the hash item key: the inline buffer or the pointer to the key.
+ *  @var HtItem::keyLen
+ *  It represents the hash item key length.<br>
+ *  A flat slot is empty when its key length is zero.
+ *  @var HtItem::keyInline
+ *  It represents true if the key is stored into the inline buffer.
+ *  @var HtItem::value
+ *  It represents the hash item value.
+ */
+typedef struct {
+    uint64_t hash;
+    union {
+        char *ptr;
+        char buf[HT_KEY_INLINE_SIZE];
+    } key;
+    unsigned int keyLen;
+    bool keyInline;
+    void *value;
+} HtItem;
 
 /** @struct HtEntry
  *  @brief This structure represents an hash entry which is an array of HtItem structure.
  *  @var HtEntry::htItems
- *  It represents the hash table items array.
+ *  It represents the hash entry items array.
+ *  @var HtEntry::size
+ *  It represents the number of the items.
+ *  @var HtEntry::capacity
+ *  It represents the number of the allocated items.
  */
 typedef struct {
-    Array *htItems;
+    HtItem *htItems;
+    int size;
+    int capacity;
 } HtEntry;
 
-/** @struct HtItem
- *  @brief This structure represents an hash item.
- *  @var HtItem::key
- *  It represents the hash item key.
- *  @var HtItem::value
- *  It represents the hash item value.
- *  @var HtItem::releaseFn
- *  It represents a generic pointer to release function.
+static inline const char *htItemKey(const HtItem *htItem)
+{
+    return htItem->keyInline ? htItem->key.buf : htItem->key.ptr;
+}
+
+/** @struct HtInternKey
+ *  @brief This structure represents a key shared by all the HT_KEY_INTERN hash tables.
+ *  @var HtInternKey::refs
+ *  It represents the number of the hash items which use the key.
+ *  @var HtInternKey::key
+ *  It represents the null-terminated key.
  */
 typedef struct {
-    char *key;
+    int refs;
+    char key[];
+} HtInternKey;
+
+/** @struct HtShard
+ *  @brief This structure represents a shard of a concurrent hash table.<br>
+ *  Every shard is aligned to a cache line so the locks of two shards never share it.
+ *  @var HtShard::lock
+ *  It represents the readers/writer lock of the shard.
+ *  @var HtShard::ht
+ *  It represents the hash table which contains the keys of the shard.
+ */
+typedef struct {
+    HT_CACHE_ALIGNED pthread_rwlock_t lock;
+    Ht *ht;
+} HtShard;
+
+/** @struct HtRcuReader
+ *  @brief This structure represents a reader thread of a read-mostly hash table.<br>
+ *  Every reader has its own cache line, so the readers never write the same memory.
+ *  @var HtRcuReader::epoch
+ *  It represents the epoch observed by the lookup in progress, zero if there is no lookup.
+ *  @var HtRcuReader::nesting
+ *  It represents the number of the nested read-side sections.
+ *  @var HtRcuReader::active
+ *  It represents true if the record is owned by a running thread.
+ *  @var HtRcuReader::next
+ *  It represents the next reader.
+ */
+typedef struct HtRcuReader {
+    HT_CACHE_ALIGNED uint64_t epoch;
+    int nesting;
+    bool active;
+    struct HtRcuReader *next;
+} HtRcuReader;
+
+/** @struct HtRcuSync
+ *  @brief This structure represents the synchronization data of a read-mostly hash table.
+ *  @var HtRcuSync::writerLock
+ *  It represents the lock which serializes the writers.
+ *  @var HtRcuSync::readerKey
+ *  It represents the key of the thread specific reader record.
+ *  @var HtRcuSync::htReaders
+ *  It represents the list of the reader records.
+ */
+typedef struct {
+    pthread_mutex_t writerLock;
+    pthread_key_t readerKey;
+    HtRcuReader *htReaders;
+} HtRcuSync;
+
+/** @struct HtIntSlot
+ *  @brief This structure represents a slot of a HtInt hash table.
+ *  @var HtIntSlot::key
+ *  It represents the key.
+ *  @var HtIntSlot::value
+ *  It represents the value.
+ *  @var HtIntSlot::used
+ *  It represents false for an empty slot.
+ */
+typedef struct {
+    uint64_t key;
     void *value;
-    void (*releaseFn)(void **);
-} HtItem;
+    bool used;
+} HtIntSlot;
+
+/** @struct StrSetSlot
+ *  @brief This structure represents a slot of a StrSet hash set.
+ *  @var StrSetSlot::hash
+ *  It represents the 64 bit hash of the key.
+ *  @var StrSetSlot::key
+ *  It represents the key copy, NULL means an empty slot.
+ */
+typedef struct {
+    uint64_t hash;
+    char *key;
+} StrSetSlot;
+
+/* ROBIN HOOD PROBING
+ * The open addressing tables (HT_FLAT, HtInt and StrSet) share the probing code.
+ * The capacity is a power of 2, the home slot of a key is given by the low bits of its hash
+ * and an empty slot is all zero.
+*/
+static inline int htProbeDist(int idx, uint64_t hash, int mask)
+{
+    return (idx - (int)(hash & mask)) & mask;
+}
+
+/* Define the probing functions of the 'Slot' slots:
+ * prefixInsert() stores a slot whose key is not present,
+ * prefixProbe() returns the index of the key or -1,
+ * prefixShiftBack() empties a slot by the backward shift deletion (no tombstones are needed),
+ * prefixMoveAll() moves all the slots into a new array.
+ * 'isEmptyFn' tells if a slot is empty, 'hashFn' returns the hash of a slot
+ * and 'matchFn' tells if a slot contains the key.
+*/
+#define HT_PROBE_DEFINE(prefix, Slot, isEmptyFn, hashFn, matchFn)                                \
+    static inline void prefix##Insert(Slot *slots, int capacity, Slot slot)                      \
+    {                                                                                            \
+        int mask = capacity - 1;                                                                 \
+        int idx = hashFn(&slot) & mask;                                                          \
+        for (int dist = 0;; dist++, idx = (idx + 1) & mask) {                                    \
+            Slot *cur = &slots[idx];                                                             \
+            if (isEmptyFn(cur)) {                                                                \
+                *cur = slot;                                                                     \
+                return;                                                                          \
+            }                                                                                    \
+            /* The richer slot (nearer to its home) gives its place to the poorer one. */        \
+            int curDist = htProbeDist(idx, hashFn(cur), mask);                                   \
+            if (curDist < dist) {                                                                \
+                Slot tmp = *cur;                                                                 \
+                *cur = slot;                                                                     \
+                slot = tmp;                                                                      \
+                dist = curDist;                                                                  \
+            }                                                                                    \
+        }                                                                                        \
+    }                                                                                            \
+                                                                                                 \
+    static inline int prefix##Probe(Slot *slots, int capacity, uint64_t hash, const void *key,   \
+                                    size_t len)                                                  \
+    {                                                                                            \
+        int mask = capacity - 1;                                                                 \
+        int idx = hash & mask;                                                                   \
+        for (int dist = 0;; dist++, idx = (idx + 1) & mask) {                                    \
+            Slot *cur = &slots[idx];                                                             \
+            /* An empty slot or a richer slot means that the key is not present. */              \
+            if (isEmptyFn(cur) || htProbeDist(idx, hashFn(cur), mask) < dist)                    \
+                return -1;                                                                       \
+            if (matchFn(cur, hash, key, len))                                                    \
+                return idx;                                                                      \
+        }                                                                                        \
+    }                                                                                            \
+                                                                                                 \
+    static inline void prefix##ShiftBack(Slot *slots, int capacity, int idx)                     \
+    {                                                                                            \
+        int mask = capacity - 1;                                                                 \
+        for (int next = (idx + 1) & mask; !isEmptyFn(&slots[next]); next = (next + 1) & mask) {  \
+            if (htProbeDist(next, hashFn(&slots[next]), mask) == 0)                              \
+                break;                                                                           \
+            slots[idx] = slots[next];                                                            \
+            idx = next;                                                                          \
+        }                                                                                        \
+        memset(&slots[idx], 0, sizeof(Slot));                                                    \
+    }                                                                                            \
+                                                                                                 \
+    static inline void prefix##MoveAll(Slot *slots, int capacity, Slot *oldSlots,                \
+                                       int oldCapacity)                                          \
+    {                                                                                            \
+        /* The stored or cheap hash gives the new slot, the keys are neither copied nor read. */ \
+        for (int i = 0; i < oldCapacity; i++) {                                                  \
+            if (!isEmptyFn(&oldSlots[i]))                                                        \
+                prefix##Insert(slots, capacity, oldSlots[i]);                                    \
+        }                                                                                        \
+    }
+
+/* RESIZE POLICY
+ * The same policy drives all the hash tables.
+*/
+static inline int htThreshold(int capacity, float loadFactor)
+{
+    return (int)(capacity * loadFactor);
+}
+
+static inline bool htPolicyGrow(const HtPolicy *policy, int capacity, int numOfItems)
+{
+    return numOfItems >= htThreshold(capacity, policy->growLoadFactor);
+}
+
+static inline bool htPolicyShrink(const HtPolicy *policy, int capacity, int numOfItems)
+{
+    return !policy->shrinkDisabled && capacity > policy->minCapacity &&
+           numOfItems <= htThreshold(capacity, policy->shrinkLoadFactor);
+}
+
+/* Return the smallest power of 2 which is greater than or equal to 'capacity'. */
+int htCapacity(int capacity);
+
+/* Return false if the 'policy' policy is not valid, NULL means the default one.
+ * The grow load factor of an open addressing table ('flat') must be less than 1.
+*/
+bool htPolicyValid(const HtPolicy *policy, bool flat);
+
+/* Copy the valid 'policy' policy, or the default one if it is NULL, into 'htPolicy'.
+ * The minimum capacity defaults to 'initialCapacity' (a power of 2).
+*/
+void htPolicyInit(HtPolicy *htPolicy, const HtPolicy *policy, int initialCapacity);
+
+/* Snapshot file of a frozen hash table */
+#define HT_SNAPSHOT_MAGIC "ULIBHTF"
+#define HT_SNAPSHOT_VERSION 1
+#define HT_SNAPSHOT_BYTE_ORDER 0x01020304
+
+/** @struct HtSnapshotHeader
+ *  @brief This structure represents the header of a frozen hash table snapshot file.<br>
+ *  The sections follow the header, each one aligned to 8 bytes:<br>
+ *  pilots (uint32_t), key offsets (uint32_t), keys, value offsets and sizes (uint64_t), values.<br>
+ *  Every value is aligned to 8 bytes too.
+ *  @var HtSnapshotHeader::magic
+ *  It represents the file signature.
+ *  @var HtSnapshotHeader::version
+ *  It represents the format version.
+ *  @var HtSnapshotHeader::byteOrder
+ *  It represents the byte order marker.
+ *  @var HtSnapshotHeader::numOfItems
+ *  It represents the number of the items.
+ *  @var HtSnapshotHeader::numOfBuckets
+ *  It represents the number of the buckets.
+ *  @var HtSnapshotHeader::seed
+ *  It represents the seed of the hash function.
+ *  @var HtSnapshotHeader::pilotsOffset
+ *  It represents the file offset of the pilots.
+ *  @var HtSnapshotHeader::keyOffsetsOffset
+ *  It represents the file offset of the key offsets.
+ *  @var HtSnapshotHeader::keysOffset
+ *  It represents the file offset of the keys blob.
+ *  @var HtSnapshotHeader::valueOffsetsOffset
+ *  It represents the file offset of the value offsets.
+ *  @var HtSnapshotHeader::valuesOffset
+ *  It represents the file offset of the values blob.
+ *  @var HtSnapshotHeader::fileSize
+ *  It represents the file size.
+ */
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t numOfItems;
+    uint32_t numOfBuckets;
+    uint64_t seed;
+    uint64_t pilotsOffset;
+    uint64_t keyOffsetsOffset;
+    uint64_t keysOffset;
+    uint64_t valueOffsetsOffset;
+    uint64_t valuesOffset;
+    uint64_t fileSize;
+} HtSnapshotHeader;
+
+/* Operation counters, they are compiled in by the HT_STATS meson option only.
+ * The atomic increments allow the concurrent lookups of HtConcurrent and HtRcu.
+*/
+#ifdef HT_STATS
+#define HT_STATS_ADD(ht, counter, n) \
+    __atomic_fetch_add(&(ht)->counters.counter, (n), __ATOMIC_RELAXED)
+static inline uint64_t htStatsNow(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+#else
+#define HT_STATS_ADD(ht, counter, n) ((void)(n))
+#define htStatsNow() ((uint64_t)0)
+#endif
+
+/* Return the seed given to the new hash tables (see htSetHashSeed()). */
+uint64_t htHashSeed(void);
+
+/* The following functions are the same of the public ones but the key hash,
+ * computed by htHash() with the hash table seed, is given by the caller.
+ * The arguments are not checked.
+*/
+uint64_t htHash(uint64_t seed, const char *key, size_t len);
+HtItem *htFindHashed(Ht *ht, const char *key, size_t len, uint64_t hash);
+void *htGetHashed(Ht *ht, const char *key, size_t len, uint64_t hash);
+bool htAddHashed(Ht *ht, const char *key, size_t len, uint64_t hash, void *value);
+void *htGetOrAddHashed(Ht *ht, const char *key, size_t len, uint64_t hash, void *value,
+                       bool *added);
+bool htRemoveHashed(Ht *ht, const char *key, size_t len, uint64_t hash);
+bool htSetHashed(Ht *ht, const char *key, size_t len, uint64_t hash, void *value);
+
+/* Return a copy of the 'ht' hash table which shares the values but not the keys.
+ * The copy has the same capacity and no rehashing in progress.
+*/
+Ht *htClone(Ht *ht);
 
 #endif // UHASHTABLE_H
@@ -0,0 +1,177 @@
+/*
+(C) 2021 by Domenico Panella <pandom79@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 3.
+See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
+*/
+
+#include "uhashtable.h"
+
+static inline HtShard *htConcurrentShard(HtConcurrent *htConcurrent, uint64_t hash)
+{
+    /* The shard is chosen by the high bits, the hash table of the shard uses the low ones. */
+    return &((HtShard *)htConcurrent->htShards)[(hash >> 32) & (htConcurrent->numOfShards - 1)];
+}
+
+HtConcurrent *htConcurrentNew(HtType type, int numOfShards, int initialCapacity,
+                              void (*releaseFn)(void **))
+{
+    assert(numOfShards > 0 && numOfShards <= (1 << 16));
+    assert(initialCapacity > 0);
+
+    HtConcurrent *htConcurrent = calloc(1, sizeof(HtConcurrent));
+    assert(htConcurrent);
+    int htNumOfShards = 1;
+    while (htNumOfShards < numOfShards)
+        htNumOfShards <<= 1;
+    htConcurrent->numOfShards = htNumOfShards;
+    HtShard *htShards = aligned_alloc(HT_CACHE_LINE_SIZE, htNumOfShards * sizeof(HtShard));
+    assert(htShards);
+    for (int i = 0; i < htNumOfShards; i++) {
+        HtShard *htShard = &htShards[i];
+        pthread_rwlock_init(&htShard->lock, NULL);
+        htShard->ht = htNewWithPolicy(type, initialCapacity, releaseFn, NULL);
+        /* The key hash is computed once for the shard and its hash table. */
+        if (i == 0)
+            htConcurrent->seed = htShard->ht->seed;
+        htShard->ht->seed = htConcurrent->seed;
+    }
+    htConcurrent->htShards = htShards;
+
+    return htConcurrent;
+}
+
+void htConcurrentRelease(HtConcurrent **htConcurrent)
+{
+    if (*htConcurrent) {
+        HtShard *htShards = (*htConcurrent)->htShards;
+        for (int i = 0; i < (*htConcurrent)->numOfShards; i++) {
+            htRelease(&htShards[i].ht);
+            pthread_rwlock_destroy(&htShards[i].lock);
+        }
+        objectRelease(&(*htConcurrent)->htShards);
+        objectRelease(htConcurrent);
+    }
+}
+
+void *htConcurrentGetN(HtConcurrent *htConcurrent, const char *key, size_t len)
+{
+    void *value = NULL;
+
+    if (htConcurrent && key && len > 0) {
+        uint64_t keyHash = htHash(htConcurrent->seed, key, len);
+        HtShard *htShard = htConcurrentShard(htConcurrent, keyHash);
+        pthread_rwlock_rdlock(&htShard->lock);
+        value = htGetHashed(htShard->ht, key, len, keyHash);
+        pthread_rwlock_unlock(&htShard->lock);
+    }
+
+    return value;
+}
+
+void *htConcurrentGet(HtConcurrent *htConcurrent, const char *key)
+{
+    return key ? htConcurrentGetN(htConcurrent, key, strlen(key)) : NULL;
+}
+
+bool htConcurrentAddN(HtConcurrent *htConcurrent, const char *key, size_t len, void *value)
+{
+    bool res = false;
+
+    if (htConcurrent && key && len > 0) {
+        uint64_t keyHash = htHash(htConcurrent->seed, key, len);
+        HtShard *htShard = htConcurrentShard(htConcurrent, keyHash);
+        pthread_rwlock_wrlock(&htShard->lock);
+        res = htAddHashed(htShard->ht, key, len, keyHash, value);
+        pthread_rwlock_unlock(&htShard->lock);
+    }
+
+    return res;
+}
+
+bool htConcurrentAdd(HtConcurrent *htConcurrent, const char *key, void *value)
+{
+    return key ? htConcurrentAddN(htConcurrent, key, strlen(key), value) : false;
+}
+
+void *htConcurrentGetOrAddN(HtConcurrent *htConcurrent, const char *key, size_t len, void *value,
+                            bool *added)
+{
+    bool htAdded = false;
+    void *htValue = NULL;
+
+    if (htConcurrent && key && len > 0) {
+        uint64_t keyHash = htHash(htConcurrent->seed, key, len);
+        HtShard *htShard = htConcurrentShard(htConcurrent, keyHash);
+        pthread_rwlock_wrlock(&htShard->lock);
+        htValue = htGetOrAddHashed(htShard->ht, key, len, keyHash, value, &htAdded);
+        pthread_rwlock_unlock(&htShard->lock);
+    }
+    if (added)
+        *added = htAdded;
+
+    return htValue;
+}
+
+void *htConcurrentGetOrAdd(HtConcurrent *htConcurrent, const char *key, void *value,
+                           bool *added)
+{
+    return htConcurrentGetOrAddN(htConcurrent, key, key ? strlen(key) : 0, value, added);
+}
+
+bool htConcurrentRemoveN(HtConcurrent *htConcurrent, const char *key, size_t len)
+{
+    bool res = false;
+
+    if (htConcurrent && key && len > 0) {
+        uint64_t keyHash = htHash(htConcurrent->seed, key, len);
+        HtShard *htShard = htConcurrentShard(htConcurrent, keyHash);
+        pthread_rwlock_wrlock(&htShard->lock);
+        res = htRemoveHashed(htShard->ht, key, len, keyHash);
+        pthread_rwlock_unlock(&htShard->lock);
+    }
+
+    return res;
+}
+
+bool htConcurrentRemove(HtConcurrent *htConcurrent, const char *key)
+{
+    return key ? htConcurrentRemoveN(htConcurrent, key, strlen(key)) : false;
+}
+
+bool htConcurrentSetN(HtConcurrent *htConcurrent, const char *key, size_t len, void *value)
+{
+    bool res = false;
+
+    if (htConcurrent && key && len > 0) {
+        uint64_t keyHash = htHash(htConcurrent->seed, key, len);
+        HtShard *htShard = htConcurrentShard(htConcurrent, keyHash);
+        pthread_rwlock_wrlock(&htShard->lock);
+        res = htSetHashed(htShard->ht, key, len, keyHash, value);
+        pthread_rwlock_unlock(&htShard->lock);
+    }
+
+    return res;
+}
+
+bool htConcurrentSet(HtConcurrent *htConcurrent, const char *key, void *value)
+{
+    return key ? htConcurrentSetN(htConcurrent, key, strlen(key), value) : false;
+}
+
+int htConcurrentNumOfItems(HtConcurrent *htConcurrent)
+{
+    int numOfItems = 0;
+
+    if (htConcurrent) {
+        HtShard *htShards = htConcurrent->htShards;
+        for (int i = 0; i < htConcurrent->numOfShards; i++) {
+            pthread_rwlock_rdlock(&htShards[i].lock);
+            numOfItems += htShards[i].ht->numOfItems;
+            pthread_rwlock_unlock(&htShards[i].lock);
+        }
+    }
+
+    return numOfItems;
+}
@@ -0,0 +1,480 @@
+/*
+(C) 2021 by Domenico Panella <pandom79@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 3.
+See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
+*/
+
+#include "uhashtable.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Average number of the keys for bucket of the perfect hash function. */
+#define HT_FROZEN_BUCKET_SIZE 3
+/* Number of the displacements tried for a bucket before changing the seed. */
+#define HT_FROZEN_MAX_PILOT (1 << 20)
+
+static inline uint64_t htFrozenMix(uint64_t x)
+{
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+static inline uint32_t htFrozenBucket(uint64_t hash, int numOfBuckets)
+{
+    /* The high bits choose the bucket, the whole hash chooses the slot. */
+    return ((hash >> 32) * (uint64_t)numOfBuckets) >> 32;
+}
+
+static inline uint32_t htFrozenSlot(uint64_t hash, uint64_t pilotMix, int numOfItems)
+{
+    return (hash ^ pilotMix) % (uint64_t)numOfItems;
+}
+
+static bool htFrozenBuild(HtFrozen *htFrozen, const uint64_t *hashes, uint32_t *slots)
+{
+    int numOfItems = htFrozen->numOfItems, numOfBuckets = htFrozen->numOfBuckets;
+    uint32_t *bucketStarts = calloc(numOfBuckets + 1, sizeof(uint32_t));
+    uint32_t *bucketItems = malloc(numOfItems * sizeof(uint32_t));
+    uint32_t *order = malloc(numOfBuckets * sizeof(uint32_t));
+    bool *taken = calloc(numOfItems, sizeof(bool));
+    assert(bucketStarts && bucketItems && order && taken);
+
+    /* Items grouped by bucket */
+    for (int i = 0; i < numOfItems; i++)
+        bucketStarts[htFrozenBucket(hashes[i], numOfBuckets) + 1]++;
+    int maxSize = 0;
+    for (int b = 0; b < numOfBuckets; b++) {
+        if ((int)bucketStarts[b + 1] > maxSize)
+            maxSize = bucketStarts[b + 1];
+        bucketStarts[b + 1] += bucketStarts[b];
+    }
+    uint32_t *cursors = calloc(numOfBuckets, sizeof(uint32_t));
+    assert(cursors);
+    for (int i = 0; i < numOfItems; i++) {
+        uint32_t b = htFrozenBucket(hashes[i], numOfBuckets);
+        bucketItems[bucketStarts[b] + cursors[b]++] = i;
+    }
+    /* The biggest buckets are placed first, while most of the slots are free. */
+    int *sizeStarts = calloc(maxSize + 2, sizeof(int));
+    assert(sizeStarts);
+    for (int b = 0; b < numOfBuckets; b++)
+        sizeStarts[maxSize - (bucketStarts[b + 1] - bucketStarts[b]) + 1]++;
+    for (int s = 0; s <= maxSize; s++)
+        sizeStarts[s + 1] += sizeStarts[s];
+    for (int b = 0; b < numOfBuckets; b++)
+        order[sizeStarts[maxSize - (bucketStarts[b + 1] - bucketStarts[b])]++] = b;
+
+    bool res = true;
+    for (int o = 0; o < numOfBuckets && res; o++) {
+        uint32_t b = order[o];
+        uint32_t *items = &bucketItems[bucketStarts[b]];
+        int size = bucketStarts[b + 1] - bucketStarts[b];
+        uint32_t pilot = 0;
+        for (; size > 0 && pilot < HT_FROZEN_MAX_PILOT; pilot++) {
+            uint64_t pilotMix = htFrozenMix(pilot);
+            int k = 0;
+            /* The keys of the same bucket must not collide each other either. */
+            for (; k < size; k++) {
+                uint32_t slot = htFrozenSlot(hashes[items[k]], pilotMix, numOfItems);
+                if (taken[slot])
+                    break;
+                taken[slot] = true;
+                slots[items[k]] = slot;
+            }
+            if (k == size)
+                break;
+            while (k-- > 0)
+                taken[slots[items[k]]] = false;
+        }
+        htFrozen->pilots[b] = pilot;
+        res = pilot < HT_FROZEN_MAX_PILOT;
+    }
+
+    objectRelease(&bucketStarts);
+    objectRelease(&bucketItems);
+    objectRelease(&order);
+    objectRelease(&taken);
+    objectRelease(&cursors);
+    objectRelease(&sizeStarts);
+
+    return res;
+}
+
+HtFrozen *htFreeze(Ht **ht)
+{
+    assert(ht && *ht);
+
+    Ht *source = *ht;
+    int numOfItems = source->numOfItems;
+    HtFrozen *htFrozen = calloc(1, sizeof(HtFrozen));
+    assert(htFrozen);
+    htFrozen->numOfItems = numOfItems;
+    htFrozen->seed = source->seed;
+    htFrozen->releaseFn = source->releaseFn;
+    if (numOfItems > 0) {
+        /* Items */
+        HtItem **htItems = malloc(numOfItems * sizeof(HtItem *));
+        assert(htItems);
+        int n = 0;
+        if (source->type == HT_FLAT) {
+            HtItem *htSlots = source->htSlots;
+            for (int i = 0; i < source->capacity; i++) {
+                if (htSlots[i].keyLen)
+                    htItems[n++] = &htSlots[i];
+            }
+        } else {
+            HtEntry *htEntriesArr[2] = { source->htEntries, source->htOldEntries };
+            int capacities[2] = { source->capacity, source->htOldEntries ? source->oldCapacity : 0 };
+            for (int j = 0; j < 2; j++) {
+                for (int i = 0; i < capacities[j]; i++) {
+                    HtEntry *htEntry = &htEntriesArr[j][i];
+                    for (int k = 0; k < htEntry->size; k++)
+                        htItems[n++] = &htEntry->htItems[k];
+                }
+            }
+        }
+        assert(n == numOfItems);
+        /* Perfect hash function */
+        htFrozen->numOfBuckets = numOfItems / HT_FROZEN_BUCKET_SIZE + 1;
+        htFrozen->pilots = malloc(htFrozen->numOfBuckets * sizeof(uint32_t));
+        uint64_t *hashes = malloc(numOfItems * sizeof(uint64_t));
+        uint32_t *slots = malloc(numOfItems * sizeof(uint32_t));
+        assert(htFrozen->pilots && hashes && slots);
+        /* The first attempt uses the hashes stored into the items. */
+        for (int i = 0; i < numOfItems; i++)
+            hashes[i] = htItems[i]->hash;
+        while (!htFrozenBuild(htFrozen, hashes, slots)) {
+            htFrozen->seed = htFrozenMix(htFrozen->seed);
+            for (int i = 0; i < numOfItems; i++)
+                hashes[i] = htHash(htFrozen->seed, htItemKey(htItems[i]), htItems[i]->keyLen);
+        }
+        /* Keys blob and values, in slots order */
+        htFrozen->keyOffsets = calloc(numOfItems + 1, sizeof(uint32_t));
+        htFrozen->values = malloc(numOfItems * sizeof(void *));
+        assert(htFrozen->keyOffsets && htFrozen->values);
+        uint32_t *keyOffsets = htFrozen->keyOffsets;
+        for (int i = 0; i < numOfItems; i++)
+            keyOffsets[slots[i] + 1] = htItems[i]->keyLen + 1;
+        for (int i = 0; i < numOfItems; i++) {
+            assert(keyOffsets[i + 1] <= UINT32_MAX - keyOffsets[i]);
+            keyOffsets[i + 1] += keyOffsets[i];
+        }
+        htFrozen->keys = malloc(keyOffsets[numOfItems]);
+        assert(htFrozen->keys);
+        for (int i = 0; i < numOfItems; i++) {
+            /* A borrowed key could be not null-terminated. */
+            char *key = htFrozen->keys + keyOffsets[slots[i]];
+            memcpy(key, htItemKey(htItems[i]), htItems[i]->keyLen);
+            key[htItems[i]->keyLen] = '\0';
+            htFrozen->values[slots[i]] = htItems[i]->value;
+        }
+        objectRelease(&htItems);
+        objectRelease(&hashes);
+        objectRelease(&slots);
+    }
+    /* The values have been moved. */
+    source->releaseFn = NULL;
+    htRelease(ht);
+
+    return htFrozen;
+}
+
+void htFrozenRelease(HtFrozen **htFrozen)
+{
+    if (*htFrozen) {
+        void (*releaseFn)(void **) = (*htFrozen)->releaseFn;
+        if (releaseFn) {
+            for (int i = 0; i < (*htFrozen)->numOfItems; i++)
+                (*releaseFn)(&(*htFrozen)->values[i]);
+        }
+        objectRelease(&(*htFrozen)->pilots);
+        objectRelease(&(*htFrozen)->keys);
+        objectRelease(&(*htFrozen)->keyOffsets);
+        objectRelease(&(*htFrozen)->values);
+        objectRelease(htFrozen);
+    }
+}
+
+void *htFrozenGetN(HtFrozen *htFrozen, const char *key, size_t len)
+{
+    if (htFrozen && key && len > 0 && htFrozen->numOfItems > 0) {
+        uint64_t keyHash = htHash(htFrozen->seed, key, len);
+        uint32_t pilot = htFrozen->pilots[htFrozenBucket(keyHash, htFrozen->numOfBuckets)];
+        uint32_t slot = htFrozenSlot(keyHash, htFrozenMix(pilot), htFrozen->numOfItems);
+        /* Every key has a slot, thus the key of the slot tells if the key exists. */
+        uint32_t offset = htFrozen->keyOffsets[slot];
+        if (htFrozen->keyOffsets[slot + 1] - offset - 1 == len &&
+            memcmp(htFrozen->keys + offset, key, len) == 0)
+            return htFrozen->values[slot];
+    }
+
+    return NULL;
+}
+
+void *htFrozenGet(HtFrozen *htFrozen, const char *key)
+{
+    return key ? htFrozenGetN(htFrozen, key, strlen(key)) : NULL;
+}
+
+void *htFrozenGetAt(HtFrozen *htFrozen, int idx, const char **key)
+{
+    if (htFrozen && idx >= 0 && idx < htFrozen->numOfItems) {
+        if (key)
+            *key = htFrozen->keys + htFrozen->keyOffsets[idx];
+        return htFrozen->values[idx];
+    }
+
+    return NULL;
+}
+
+/* SNAPSHOT */
+
+static inline uint64_t htSnapshotAlign(uint64_t offset)
+{
+    return (offset + 7) & ~(uint64_t)7;
+}
+
+static bool htSnapshotWrite(FILE *file, const void *data, size_t size)
+{
+    static const char zeros[8] = { 0 };
+    size_t padding = htSnapshotAlign(size) - size;
+
+    /* NULL data is written as zeros. */
+    if (!data) {
+        for (size_t n = size + padding; n > 0; n -= sizeof(zeros)) {
+            if (fwrite(zeros, 1, sizeof(zeros), file) != sizeof(zeros))
+                return false;
+        }
+        return true;
+    }
+
+    return (size == 0 || fwrite(data, 1, size, file) == size) &&
+           (padding == 0 || fwrite(zeros, 1, padding, file) == padding);
+}
+
+static bool htSnapshotSyncDir(const char *path)
+{
+    /* The rename is durable only when the directory which contains the file is on disk. */
+    const char *slash = strrchr(path, '/');
+    size_t len = slash ? (slash == path ? 1 : (size_t)(slash - path)) : 1;
+    char *dirPath = malloc(len + 1);
+    assert(dirPath);
+    memcpy(dirPath, slash ? path : ".", len);
+    dirPath[len] = '\0';
+    int fd = open(dirPath, O_RDONLY | O_DIRECTORY);
+    bool res = fd != -1 && fsync(fd) == 0;
+    if (fd != -1)
+        close(fd);
+    objectRelease(&dirPath);
+
+    return res;
+}
+
+bool htFrozenWrite(HtFrozen *htFrozen, const char *path, size_t (*valueSizeFn)(const void *))
+{
+    if (!htFrozen || !path)
+        return false;
+
+    int numOfItems = htFrozen->numOfItems;
+    uint32_t emptyKeyOffsets[1] = { 0 };
+    const uint32_t *keyOffsets = numOfItems > 0 ? htFrozen->keyOffsets : emptyKeyOffsets;
+    /* Header */
+    HtSnapshotHeader header;
+    memset(&header, 0, sizeof(HtSnapshotHeader));
+    memcpy(header.magic, HT_SNAPSHOT_MAGIC, sizeof(HT_SNAPSHOT_MAGIC));
+    header.version = HT_SNAPSHOT_VERSION;
+    header.byteOrder = HT_SNAPSHOT_BYTE_ORDER;
+    header.numOfItems = numOfItems;
+    header.numOfBuckets = htFrozen->numOfBuckets;
+    header.seed = htFrozen->seed;
+    header.pilotsOffset = htSnapshotAlign(sizeof(HtSnapshotHeader));
+    header.keyOffsetsOffset =
+        htSnapshotAlign(header.pilotsOffset + header.numOfBuckets * sizeof(uint32_t));
+    header.keysOffset =
+        htSnapshotAlign(header.keyOffsetsOffset + (numOfItems + 1) * sizeof(uint32_t));
+    header.valueOffsetsOffset = htSnapshotAlign(header.keysOffset + keyOffsets[numOfItems]);
+    header.valuesOffset =
+        htSnapshotAlign(header.valueOffsetsOffset + numOfItems * 2 * sizeof(uint64_t));
+    /* Value offsets and sizes */
+    uint64_t *valueOffsets = malloc((numOfItems * 2 + 1) * sizeof(uint64_t));
+    assert(valueOffsets);
+    uint64_t offset = 0;
+    for (int i = 0; i < numOfItems; i++) {
+        const char *value = htFrozen->values[i];
+        uint64_t size = valueSizeFn ? (*valueSizeFn)(value) : (value ? strlen(value) + 1 : 1);
+        valueOffsets[i * 2] = offset;
+        valueOffsets[i * 2 + 1] = size;
+        offset += htSnapshotAlign(size);
+    }
+    header.fileSize = header.valuesOffset + offset;
+
+    /* The file is replaced at once, a reader never maps a partial snapshot.
+     * The temporary file is unique so the concurrent writers don't clobber each other.
+    */
+    size_t lenPath = strlen(path);
+    char *tmpPath = malloc(lenPath + 8);
+    assert(tmpPath);
+    memcpy(tmpPath, path, lenPath);
+    memcpy(tmpPath + lenPath, ".XXXXXX", 8);
+    int fd = mkstemp(tmpPath);
+    FILE *file = NULL;
+    if (fd != -1) {
+        /* mkstemp() creates the file readable by its owner only. */
+        file = fchmod(fd, 0644) == 0 ? fdopen(fd, "wb") : NULL;
+        if (!file) {
+            close(fd);
+            unlink(tmpPath);
+        }
+    }
+    bool res = file != NULL;
+    if (res) {
+        res = htSnapshotWrite(file, &header, sizeof(HtSnapshotHeader)) &&
+              htSnapshotWrite(file, htFrozen->pilots, header.numOfBuckets * sizeof(uint32_t)) &&
+              htSnapshotWrite(file, keyOffsets, (numOfItems + 1) * sizeof(uint32_t)) &&
+              htSnapshotWrite(file, htFrozen->keys, keyOffsets[numOfItems]) &&
+              htSnapshotWrite(file, valueOffsets, numOfItems * 2 * sizeof(uint64_t));
+        for (int i = 0; i < numOfItems && res; i++)
+            res = htSnapshotWrite(file, htFrozen->values[i], valueOffsets[i * 2 + 1]);
+        /* The data must be on disk before the rename, a crash must not leave an empty snapshot. */
+        res = res && fflush(file) == 0 && fsync(fileno(file)) == 0;
+        res = fclose(file) == 0 && res;
+        res = res && rename(tmpPath, path) == 0;
+        if (!res)
+            unlink(tmpPath);
+        else
+            res = htSnapshotSyncDir(path);
+    }
+    objectRelease(&tmpPath);
+    objectRelease(&valueOffsets);
+
+    return res;
+}
+
+static bool htSnapshotValid(const HtSnapshotHeader *header, uint64_t fileSize)
+{
+    if (memcmp(header->magic, HT_SNAPSHOT_MAGIC, sizeof(HT_SNAPSHOT_MAGIC)) != 0 ||
+        header->version != HT_SNAPSHOT_VERSION || header->byteOrder != HT_SNAPSHOT_BYTE_ORDER ||
+        header->fileSize != fileSize || header->numOfItems > INT32_MAX ||
+        header->numOfBuckets > INT32_MAX || (header->numOfItems > 0 && header->numOfBuckets == 0))
+        return false;
+    /* The sections are aligned, sorted and inside the file. */
+    uint64_t sections[6] = { header->pilotsOffset,       header->keyOffsetsOffset,
+                             header->keysOffset,         header->valueOffsetsOffset,
+                             header->valuesOffset,       fileSize };
+    uint64_t minSizes[5] = { (uint64_t)header->numOfBuckets * sizeof(uint32_t),
+                             ((uint64_t)header->numOfItems + 1) * sizeof(uint32_t), 0,
+                             (uint64_t)header->numOfItems * 2 * sizeof(uint64_t), 0 };
+    if (sections[0] < sizeof(HtSnapshotHeader))
+        return false;
+    for (int i = 0; i < 5; i++) {
+        if (sections[i] % 8 != 0 || sections[i + 1] < sections[i] ||
+            sections[i + 1] - sections[i] < minSizes[i])
+            return false;
+    }
+    const char *base = (const char *)header;
+    const uint32_t *keyOffsets = (const uint32_t *)(base + header->keyOffsetsOffset);
+    const char *keys = base + header->keysOffset;
+    uint64_t keysSize = header->valueOffsetsOffset - header->keysOffset;
+    if (keyOffsets[0] != 0)
+        return false;
+    /* Every key is not empty and NUL terminated inside the keys section. */
+    for (uint32_t i = 0; i < header->numOfItems; i++) {
+        if (keyOffsets[i + 1] > keysSize || keyOffsets[i + 1] < (uint64_t)keyOffsets[i] + 2 ||
+            keys[keyOffsets[i + 1] - 1] != '\0')
+            return false;
+    }
+    /* Every value is aligned and inside the values section. */
+    const uint64_t *valueOffsets = (const uint64_t *)(base + header->valueOffsetsOffset);
+    uint64_t valuesSize = fileSize - header->valuesOffset;
+    for (uint32_t i = 0; i < header->numOfItems; i++) {
+        uint64_t offset = valueOffsets[i * 2], size = valueOffsets[i * 2 + 1];
+        if (offset % 8 != 0 || offset > valuesSize || size > valuesSize - offset)
+            return false;
+    }
+
+    return true;
+}
+
+HtMapped *htMappedOpen(const char *path)
+{
+    HtMapped *htMapped = NULL;
+
+    int fd = path ? open(path, O_RDONLY | O_CLOEXEC) : -1;
+    if (fd == -1)
+        return NULL;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size >= (off_t)sizeof(HtSnapshotHeader)) {
+        void *map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (map != MAP_FAILED) {
+            const HtSnapshotHeader *header = map;
+            if (htSnapshotValid(header, st.st_size)) {
+                const char *base = map;
+                htMapped = calloc(1, sizeof(HtMapped));
+                assert(htMapped);
+                htMapped->numOfItems = header->numOfItems;
+                htMapped->numOfBuckets = header->numOfBuckets;
+                htMapped->seed = header->seed;
+                htMapped->pilots = (const uint32_t *)(base + header->pilotsOffset);
+                htMapped->keyOffsets = (const uint32_t *)(base + header->keyOffsetsOffset);
+                htMapped->keys = base + header->keysOffset;
+                htMapped->valueOffsets = (const uint64_t *)(base + header->valueOffsetsOffset);
+                htMapped->values = base + header->valuesOffset;
+                htMapped->map = map;
+                htMapped->mapSize = st.st_size;
+            } else {
+                munmap(map, st.st_size);
+            }
+        }
+    }
+    close(fd);
+
+    return htMapped;
+}
+
+void htMappedClose(HtMapped **htMapped)
+{
+    if (*htMapped) {
+        munmap((*htMapped)->map, (*htMapped)->mapSize);
+        objectRelease(htMapped);
+    }
+}
+
+const void *htMappedGetN(HtMapped *htMapped, const char *key, size_t len, size_t *size)
+{
+    if (htMapped && key && len > 0 && htMapped->numOfItems > 0) {
+        /* The same lookup of htFrozenGetN() function on the mapped sections. */
+        uint64_t keyHash = htHash(htMapped->seed, key, len);
+        uint32_t pilot = htMapped->pilots[htFrozenBucket(keyHash, htMapped->numOfBuckets)];
+        uint32_t slot = htFrozenSlot(keyHash, htFrozenMix(pilot), htMapped->numOfItems);
+        uint32_t offset = htMapped->keyOffsets[slot];
+        if (htMapped->keyOffsets[slot + 1] - offset - 1 == len &&
+            memcmp(htMapped->keys + offset, key, len) == 0)
+            return htMappedGetAt(htMapped, slot, NULL, size);
+    }
+
+    return NULL;
+}
+
+const void *htMappedGet(HtMapped *htMapped, const char *key, size_t *size)
+{
+    return key ? htMappedGetN(htMapped, key, strlen(key), size) : NULL;
+}
+
+const void *htMappedGetAt(HtMapped *htMapped, int idx, const char **key, size_t *size)
+{
+    if (htMapped && idx >= 0 && idx < htMapped->numOfItems) {
+        if (key)
+            *key = htMapped->keys + htMapped->keyOffsets[idx];
+        if (size)
+            *size = htMapped->valueOffsets[idx * 2 + 1];
+        return htMapped->values + htMapped->valueOffsets[idx * 2];
+    }
+
+    return NULL;
+}
@@ -0,0 +1,276 @@
+/*
+(C) 2021 by Domenico Panella <pandom79@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 3.
+See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
+*/
+
+#include "uhashtable.h"
+
+static inline uint64_t htIntHash(uint64_t key)
+{
+    /* The splitmix64 finalizer: every key bit changes the low bits used by the mask. */
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+
+    return key;
+}
+
+static inline bool htIntIsEmpty(const HtIntSlot *htSlot)
+{
+    return !htSlot->used;
+}
+
+static inline uint64_t htIntSlotHash(const HtIntSlot *htSlot)
+{
+    /* The hash is not stored, the mixer is cheaper than a bigger slot. */
+    return htIntHash(htSlot->key);
+}
+
+static inline bool htIntMatch(const HtIntSlot *htSlot, uint64_t hash, const void *key, size_t len)
+{
+    (void)hash;
+    (void)len;
+    return htSlot->key == *(const uint64_t *)key;
+}
+
+HT_PROBE_DEFINE(htIntSlot, HtIntSlot, htIntIsEmpty, htIntSlotHash, htIntMatch)
+
+static inline int htIntFind(HtInt *htInt, uint64_t key)
+{
+    return htIntSlotProbe(htInt->htSlots, htInt->capacity, htIntHash(key), &key, sizeof(key));
+}
+
+static void htIntResize(HtInt *htInt, int capacity)
+{
+    HtIntSlot *oldHtSlots = htInt->htSlots;
+    HtIntSlot *htSlots = calloc(capacity, sizeof(HtIntSlot));
+    assert(htSlots);
+    htIntSlotMoveAll(htSlots, capacity, oldHtSlots, htInt->capacity);
+    objectRelease(&oldHtSlots);
+    htInt->htSlots = htSlots;
+    htInt->capacity = capacity;
+    htInt->version++;
+}
+
+static void htIntAddNew(HtInt *htInt, uint64_t key, void *value)
+{
+    HtIntSlot htSlot = { .key = key, .value = value, .used = true };
+    htIntSlotInsert(htInt->htSlots, htInt->capacity, htSlot);
+    htInt->numOfItems++;
+    htInt->version++;
+    if (htPolicyGrow(&htInt->policy, htInt->capacity, htInt->numOfItems))
+        htIntResize(htInt, htInt->capacity * 2);
+}
+
+HtInt *htIntNewWithPolicy(int initialCapacity, void (*releaseFn)(void **),
+                          const HtPolicy *policy)
+{
+    assert(initialCapacity > 0);
+
+    if (!htPolicyValid(policy, true))
+        return NULL;
+
+    HtInt *htInt = calloc(1, sizeof(HtInt));
+    assert(htInt);
+    htInt->initialCapacity = htCapacity(initialCapacity);
+    htPolicyInit(&htInt->policy, policy, htInt->initialCapacity);
+    htInt->capacity = htInt->initialCapacity;
+    if (htInt->capacity < htInt->policy.minCapacity)
+        htInt->capacity = htInt->policy.minCapacity;
+    htInt->htSlots = calloc(htInt->capacity, sizeof(HtIntSlot));
+    assert(htInt->htSlots);
+    htInt->releaseFn = releaseFn;
+
+    return htInt;
+}
+
+HtInt *htIntNew(int initialCapacity, void (*releaseFn)(void **))
+{
+    return htIntNewWithPolicy(initialCapacity, releaseFn, NULL);
+}
+
+void htIntRelease(HtInt **htInt)
+{
+    if (*htInt) {
+        HtIntSlot *htSlots = (*htInt)->htSlots;
+        if ((*htInt)->releaseFn) {
+            for (int i = 0; i < (*htInt)->capacity; i++) {
+                if (htSlots[i].used)
+                    (*(*htInt)->releaseFn)(&htSlots[i].value);
+            }
+        }
+        objectRelease(&(*htInt)->htSlots);
+        objectRelease(htInt);
+    }
+}
+
+void *htIntGet(HtInt *htInt, uint64_t key)
+{
+    if (htInt) {
+        int idx = htIntFind(htInt, key);
+        if (idx != -1)
+            return ((HtIntSlot *)htInt->htSlots)[idx].value;
+    }
+
+    return NULL;
+}
+
+bool htIntAdd(HtInt *htInt, uint64_t key, void *value)
+{
+    if (htInt && htIntFind(htInt, key) == -1) {
+        htIntAddNew(htInt, key, value);
+        return true;
+    }
+
+    return false;
+}
+
+void *htIntGetOrAdd(HtInt *htInt, uint64_t key, void *value, bool *added)
+{
+    bool htAdded = false;
+    void *htValue = NULL;
+
+    if (htInt) {
+        int idx = htIntFind(htInt, key);
+        if (idx != -1) {
+            htValue = ((HtIntSlot *)htInt->htSlots)[idx].value;
+        } else {
+            htIntAddNew(htInt, key, value);
+            htValue = value;
+            htAdded = true;
+        }
+    }
+    if (added)
+        *added = htAdded;
+
+    return htValue;
+}
+
+bool htIntRemove(HtInt *htInt, uint64_t key)
+{
+    int idx = htInt ? htIntFind(htInt, key) : -1;
+    if (idx == -1)
+        return false;
+
+    HtIntSlot *htSlots = htInt->htSlots;
+    if (htInt->releaseFn)
+        (*htInt->releaseFn)(&htSlots[idx].value);
+    htIntSlotShiftBack(htSlots, htInt->capacity, idx);
+    htInt->numOfItems--;
+    htInt->version++;
+    if (htPolicyShrink(&htInt->policy, htInt->capacity, htInt->numOfItems))
+        htIntResize(htInt, htInt->capacity / 2);
+
+    return true;
+}
+
+bool htIntSet(HtInt *htInt, uint64_t key, void *value)
+{
+    int idx = htInt ? htIntFind(htInt, key) : -1;
+    if (idx == -1)
+        return false;
+
+    HtIntSlot *htSlot = &((HtIntSlot *)htInt->htSlots)[idx];
+    if (htInt->releaseFn)
+        (*htInt->releaseFn)(&htSlot->value);
+    htSlot->value = value;
+
+    return true;
+}
+
+void htIntIterInit(HtInt *htInt, HtIntIterator *htIntIter)
+{
+    if (htInt && htIntIter) {
+        htIntIter->htInt = htInt;
+        htIntIter->idx = 0;
+        htIntIter->version = htInt->version;
+    }
+}
+
+bool htIntIterNext(HtIntIterator *htIntIter, uint64_t *key, void **value)
+{
+    /* The hash table must not be modified after the iterator initialization. */
+    if (htIntIter && htIntIter->htInt && htIntIter->version == htIntIter->htInt->version) {
+        HtInt *htInt = htIntIter->htInt;
+        HtIntSlot *htSlots = htInt->htSlots;
+        for (; htIntIter->idx < htInt->capacity; htIntIter->idx++) {
+            HtIntSlot *htSlot = &htSlots[htIntIter->idx];
+            if (htSlot->used) {
+                if (key)
+                    *key = htSlot->key;
+                if (value)
+                    *value = htSlot->value;
+                htIntIter->idx++;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+/* POINTER KEYS */
+
+HtPtr *htPtrNew(int initialCapacity, void (*releaseFn)(void **))
+{
+    return htIntNew(initialCapacity, releaseFn);
+}
+
+HtPtr *htPtrNewWithPolicy(int initialCapacity, void (*releaseFn)(void **),
+                          const HtPolicy *policy)
+{
+    return htIntNewWithPolicy(initialCapacity, releaseFn, policy);
+}
+
+void htPtrRelease(HtPtr **htPtr)
+{
+    htIntRelease(htPtr);
+}
+
+void *htPtrGet(HtPtr *htPtr, const void *key)
+{
+    return htIntGet(htPtr, (uintptr_t)key);
+}
+
+bool htPtrAdd(HtPtr *htPtr, const void *key, void *value)
+{
+    return htIntAdd(htPtr, (uintptr_t)key, value);
+}
+
+void *htPtrGetOrAdd(HtPtr *htPtr, const void *key, void *value, bool *added)
+{
+    return htIntGetOrAdd(htPtr, (uintptr_t)key, value, added);
+}
+
+bool htPtrRemove(HtPtr *htPtr, const void *key)
+{
+    return htIntRemove(htPtr, (uintptr_t)key);
+}
+
+bool htPtrSet(HtPtr *htPtr, const void *key, void *value)
+{
+    return htIntSet(htPtr, (uintptr_t)key, value);
+}
+
+void htPtrIterInit(HtPtr *htPtr, HtIntIterator *htPtrIter)
+{
+    htIntIterInit(htPtr, htPtrIter);
+}
+
+bool htPtrIterNext(HtIntIterator *htPtrIter, const void **key, void **value)
+{
+    uint64_t htKey = 0;
+
+    if (htIntIterNext(htPtrIter, &htKey, value)) {
+        if (key)
+            *key = (const void *)(uintptr_t)htKey;
+        return true;
+    }
+
+    return false;
+}
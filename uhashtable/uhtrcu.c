@@ -0,0 +1,212 @@
+/*
+(C) 2021 by Domenico Panella <pandom79@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 3.
+See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
+*/
+
+#include "uhashtable.h"
+#include <sched.h>
+
+typedef enum { HT_RCU_ADD = 0, HT_RCU_REMOVE = 1, HT_RCU_SET = 2 } HtRcuOp;
+
+static void htRcuReaderExit(void *arg)
+{
+    /* The record of an ended thread can be reused by a new one. */
+    HtRcuReader *htReader = arg;
+    htReader->nesting = 0;
+    __atomic_store_n(&htReader->epoch, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&htReader->active, false, __ATOMIC_RELEASE);
+}
+
+static HtRcuReader *htRcuReader(HtRcu *htRcu)
+{
+    HtRcuSync *htRcuSync = htRcu->htRcuSync;
+    HtRcuReader *htReader = pthread_getspecific(htRcuSync->readerKey);
+    if (!htReader) {
+        /* Only the first lookup of a thread takes the lock to register its record. */
+        pthread_mutex_lock(&htRcuSync->writerLock);
+        for (htReader = htRcuSync->htReaders; htReader; htReader = htReader->next) {
+            if (!__atomic_load_n(&htReader->active, __ATOMIC_ACQUIRE))
+                break;
+        }
+        if (!htReader) {
+            htReader = aligned_alloc(HT_CACHE_LINE_SIZE, sizeof(HtRcuReader));
+            assert(htReader);
+            memset(htReader, 0, sizeof(HtRcuReader));
+            htReader->next = htRcuSync->htReaders;
+            htRcuSync->htReaders = htReader;
+        }
+        htReader->active = true;
+        pthread_mutex_unlock(&htRcuSync->writerLock);
+        pthread_setspecific(htRcuSync->readerKey, htReader);
+    }
+
+    return htReader;
+}
+
+static void htRcuSynchronize(HtRcu *htRcu)
+{
+    HtRcuSync *htRcuSync = htRcu->htRcuSync;
+    uint64_t epoch = htRcu->epoch + 1;
+
+    /* The readers which observe the new epoch read the hash table published before it. */
+    __atomic_store_n(&htRcu->epoch, epoch, __ATOMIC_SEQ_CST);
+    for (HtRcuReader *htReader = htRcuSync->htReaders; htReader; htReader = htReader->next) {
+        uint64_t readerEpoch;
+        while ((readerEpoch = __atomic_load_n(&htReader->epoch, __ATOMIC_SEQ_CST)) != 0 &&
+               readerEpoch < epoch)
+            sched_yield();
+    }
+}
+
+static bool htRcuWrite(HtRcu *htRcu, HtRcuOp op, const char *key, size_t len, void *value)
+{
+    HtRcuSync *htRcuSync = htRcu->htRcuSync;
+    bool res = false;
+
+    pthread_mutex_lock(&htRcuSync->writerLock);
+    Ht *ht = htRcu->ht;
+    uint64_t keyHash = htHash(ht->seed, key, len);
+    HtItem *htItem = htFindHashed(ht, key, len, keyHash);
+    /* The hash table is not copied if the modification would fail. */
+    if ((op == HT_RCU_ADD) == !htItem) {
+        void *oldValue = htItem ? htItem->value : NULL;
+        void (*releaseFn)(void **) = ht->releaseFn;
+        Ht *htNew = htClone(ht);
+        /* The readers could be using the old value: it is released after the grace period. */
+        htNew->releaseFn = NULL;
+        if (op == HT_RCU_ADD)
+            htAddHashed(htNew, key, len, keyHash, value);
+        else if (op == HT_RCU_REMOVE)
+            htRemoveHashed(htNew, key, len, keyHash);
+        else
+            htSetHashed(htNew, key, len, keyHash, value);
+        htNew->releaseFn = releaseFn;
+        __atomic_store_n(&htRcu->ht, htNew, __ATOMIC_SEQ_CST);
+        htRcuSynchronize(htRcu);
+        /* The values which are still into the new hash table must not be released. */
+        ht->releaseFn = NULL;
+        htRelease(&ht);
+        if (releaseFn && op != HT_RCU_ADD)
+            (*releaseFn)(&oldValue);
+        res = true;
+    }
+    pthread_mutex_unlock(&htRcuSync->writerLock);
+
+    return res;
+}
+
+HtRcu *htRcuNew(Ht **ht)
+{
+    assert(ht && *ht);
+
+    HtRcu *htRcu = calloc(1, sizeof(HtRcu));
+    assert(htRcu);
+    HtRcuSync *htRcuSync = calloc(1, sizeof(HtRcuSync));
+    assert(htRcuSync);
+    pthread_mutex_init(&htRcuSync->writerLock, NULL);
+    int rv = pthread_key_create(&htRcuSync->readerKey, htRcuReaderExit);
+    assert(rv == 0);
+    (void)rv;
+    htRcu->htRcuSync = htRcuSync;
+    /* Zero is the epoch of the readers outside of a read-side section. */
+    htRcu->epoch = 1;
+    /* Every modification copies the whole hash table, the incremental rehashing is useless. */
+    htSetRehashStep(*ht, 0);
+    htRcu->ht = *ht;
+    *ht = NULL;
+
+    return htRcu;
+}
+
+void htRcuRelease(HtRcu **htRcu)
+{
+    if (*htRcu) {
+        HtRcuSync *htRcuSync = (*htRcu)->htRcuSync;
+        htRelease(&(*htRcu)->ht);
+        pthread_key_delete(htRcuSync->readerKey);
+        HtRcuReader *htReader = htRcuSync->htReaders;
+        while (htReader) {
+            HtRcuReader *next = htReader->next;
+            objectRelease(&htReader);
+            htReader = next;
+        }
+        pthread_mutex_destroy(&htRcuSync->writerLock);
+        objectRelease(&(*htRcu)->htRcuSync);
+        objectRelease(htRcu);
+    }
+}
+
+void htRcuReadLock(HtRcu *htRcu)
+{
+    if (htRcu) {
+        HtRcuReader *htReader = htRcuReader(htRcu);
+        if (htReader->nesting++ == 0) {
+            __atomic_store_n(&htReader->epoch, __atomic_load_n(&htRcu->epoch, __ATOMIC_RELAXED),
+                             __ATOMIC_RELAXED);
+            /* The epoch must be visible to the writers before the hash table is read. */
+            __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        }
+    }
+}
+
+void htRcuReadUnlock(HtRcu *htRcu)
+{
+    if (htRcu) {
+        HtRcuReader *htReader = pthread_getspecific(((HtRcuSync *)htRcu->htRcuSync)->readerKey);
+        assert(htReader && htReader->nesting > 0);
+        if (--htReader->nesting == 0)
+            __atomic_store_n(&htReader->epoch, 0, __ATOMIC_RELEASE);
+    }
+}
+
+void *htRcuGetN(HtRcu *htRcu, const char *key, size_t len)
+{
+    void *value = NULL;
+
+    if (htRcu && key && len > 0) {
+        htRcuReadLock(htRcu);
+        Ht *ht = __atomic_load_n(&htRcu->ht, __ATOMIC_ACQUIRE);
+        value = htGetHashed(ht, key, len, htHash(ht->seed, key, len));
+        htRcuReadUnlock(htRcu);
+    }
+
+    return value;
+}
+
+void *htRcuGet(HtRcu *htRcu, const char *key)
+{
+    return key ? htRcuGetN(htRcu, key, strlen(key)) : NULL;
+}
+
+bool htRcuAddN(HtRcu *htRcu, const char *key, size_t len, void *value)
+{
+    return htRcu && key && len > 0 ? htRcuWrite(htRcu, HT_RCU_ADD, key, len, value) : false;
+}
+
+bool htRcuAdd(HtRcu *htRcu, const char *key, void *value)
+{
+    return key ? htRcuAddN(htRcu, key, strlen(key), value) : false;
+}
+
+bool htRcuRemoveN(HtRcu *htRcu, const char *key, size_t len)
+{
+    return htRcu && key && len > 0 ? htRcuWrite(htRcu, HT_RCU_REMOVE, key, len, NULL) : false;
+}
+
+bool htRcuRemove(HtRcu *htRcu, const char *key)
+{
+    return key ? htRcuRemoveN(htRcu, key, strlen(key)) : false;
+}
+
+bool htRcuSetN(HtRcu *htRcu, const char *key, size_t len, void *value)
+{
+    return htRcu && key && len > 0 ? htRcuWrite(htRcu, HT_RCU_SET, key, len, value) : false;
+}
+
+bool htRcuSet(HtRcu *htRcu, const char *key, void *value)
+{
+    return key ? htRcuSetN(htRcu, key, strlen(key), value) : false;
+}
@@ -0,0 +1,211 @@
+/*
+(C) 2021 by Domenico Panella <pandom79@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 3.
+See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
+*/
+
+#include "uhashtable.h"
+
+static inline bool strSetIsEmpty(const StrSetSlot *htSlot)
+{
+    return !htSlot->key;
+}
+
+static inline uint64_t strSetStoredHash(const StrSetSlot *htSlot)
+{
+    return htSlot->hash;
+}
+
+static inline bool strSetMatch(const StrSetSlot *htSlot, uint64_t hash, const void *key,
+                               size_t len)
+{
+    (void)len;
+    return htSlot->hash == hash && strcmp(htSlot->key, key) == 0;
+}
+
+HT_PROBE_DEFINE(strSetSlot, StrSetSlot, strSetIsEmpty, strSetStoredHash, strSetMatch)
+
+static inline int strSetFind(StrSet *strSet, const char *key, uint64_t hash)
+{
+    return strSetSlotProbe(strSet->htSlots, strSet->capacity, hash, key, 0);
+}
+
+static void strSetResize(StrSet *strSet, int capacity)
+{
+    StrSetSlot *oldHtSlots = strSet->htSlots;
+    StrSetSlot *htSlots = calloc(capacity, sizeof(StrSetSlot));
+    assert(htSlots);
+    strSetSlotMoveAll(htSlots, capacity, oldHtSlots, strSet->capacity);
+    objectRelease(&oldHtSlots);
+    strSet->htSlots = htSlots;
+    strSet->capacity = capacity;
+    strSet->version++;
+}
+
+static void strSetAddNew(StrSet *strSet, const char *key, uint64_t hash)
+{
+    StrSetSlot htSlot = { .hash = hash, .key = stringNew(key) };
+    strSetSlotInsert(strSet->htSlots, strSet->capacity, htSlot);
+    strSet->numOfItems++;
+    strSet->version++;
+    if (htPolicyGrow(&strSet->policy, strSet->capacity, strSet->numOfItems))
+        strSetResize(strSet, strSet->capacity * 2);
+}
+
+static bool strSetAddHashed(StrSet *strSet, const char *key, uint64_t hash)
+{
+    if (strSetFind(strSet, key, hash) != -1)
+        return false;
+    strSetAddNew(strSet, key, hash);
+
+    return true;
+}
+
+static inline uint64_t strSetHash(StrSet *strSet, const char *key)
+{
+    return htHash(strSet->seed, key, strlen(key));
+}
+
+static inline uint64_t strSetSlotHash(StrSet *strSet, StrSet *slotStrSet, StrSetSlot *htSlot)
+{
+    /* The hash of a key of another hash set is reused if the seeds are equal. */
+    return strSet->seed == slotStrSet->seed ? htSlot->hash : strSetHash(strSet, htSlot->key);
+}
+
+StrSet *strSetNewWithPolicy(int initialCapacity, const HtPolicy *policy)
+{
+    assert(initialCapacity > 0);
+
+    if (!htPolicyValid(policy, true))
+        return NULL;
+
+    StrSet *strSet = calloc(1, sizeof(StrSet));
+    assert(strSet);
+    strSet->initialCapacity = htCapacity(initialCapacity);
+    htPolicyInit(&strSet->policy, policy, strSet->initialCapacity);
+    strSet->capacity = strSet->initialCapacity;
+    if (strSet->capacity < strSet->policy.minCapacity)
+        strSet->capacity = strSet->policy.minCapacity;
+    strSet->seed = htHashSeed();
+    strSet->htSlots = calloc(strSet->capacity, sizeof(StrSetSlot));
+    assert(strSet->htSlots);
+
+    return strSet;
+}
+
+StrSet *strSetNew(int initialCapacity)
+{
+    return strSetNewWithPolicy(initialCapacity, NULL);
+}
+
+void strSetRelease(StrSet **strSet)
+{
+    if (*strSet) {
+        StrSetSlot *htSlots = (*strSet)->htSlots;
+        for (int i = 0; i < (*strSet)->capacity; i++)
+            objectRelease(&htSlots[i].key);
+        objectRelease(&(*strSet)->htSlots);
+        objectRelease(strSet);
+    }
+}
+
+bool strSetAdd(StrSet *strSet, const char *key)
+{
+    return strSet && key && *key ? strSetAddHashed(strSet, key, strSetHash(strSet, key)) : false;
+}
+
+bool strSetContains(StrSet *strSet, const char *key)
+{
+    return strSet && key && *key ? strSetFind(strSet, key, strSetHash(strSet, key)) != -1 : false;
+}
+
+bool strSetRemove(StrSet *strSet, const char *key)
+{
+    int idx = strSet && key && *key ? strSetFind(strSet, key, strSetHash(strSet, key)) : -1;
+    if (idx == -1)
+        return false;
+
+    StrSetSlot *htSlots = strSet->htSlots;
+    objectRelease(&htSlots[idx].key);
+    strSetSlotShiftBack(htSlots, strSet->capacity, idx);
+    strSet->numOfItems--;
+    strSet->version++;
+    if (htPolicyShrink(&strSet->policy, strSet->capacity, strSet->numOfItems))
+        strSetResize(strSet, strSet->capacity / 2);
+
+    return true;
+}
+
+StrSet *strSetUnion(StrSet *strSet1, StrSet *strSet2)
+{
+    if (strSet1 && strSet2) {
+        /* The capacity is reserved for all the keys, the union never grows while it is built. */
+        StrSet *strSet = strSetNewWithPolicy(strSet1->initialCapacity, &strSet1->policy);
+        int numOfItems = strSet1->numOfItems + strSet2->numOfItems, capacity = strSet->capacity;
+        while (htPolicyGrow(&strSet->policy, capacity, numOfItems))
+            capacity <<= 1;
+        if (capacity > strSet->capacity)
+            strSetResize(strSet, capacity);
+        StrSet *strSets[2] = { strSet1, strSet2 };
+        for (int j = 0; j < 2; j++) {
+            StrSetSlot *htSlots = strSets[j]->htSlots;
+            for (int i = 0; i < strSets[j]->capacity; i++) {
+                if (htSlots[i].key)
+                    strSetAddHashed(strSet, htSlots[i].key,
+                                    strSetSlotHash(strSet, strSets[j], &htSlots[i]));
+            }
+        }
+        return strSet;
+    }
+
+    return NULL;
+}
+
+StrSet *strSetIntersection(StrSet *strSet1, StrSet *strSet2)
+{
+    if (strSet1 && strSet2) {
+        StrSet *smallSet = strSet1->numOfItems <= strSet2->numOfItems ? strSet1 : strSet2;
+        StrSet *largeSet = smallSet == strSet1 ? strSet2 : strSet1;
+        StrSet *strSet = strSetNewWithPolicy(smallSet->initialCapacity, &smallSet->policy);
+        StrSetSlot *htSlots = smallSet->htSlots;
+        for (int i = 0; i < smallSet->capacity; i++) {
+            StrSetSlot *htSlot = &htSlots[i];
+            if (htSlot->key &&
+                strSetFind(largeSet, htSlot->key, strSetSlotHash(largeSet, smallSet, htSlot)) != -1)
+                strSetAddNew(strSet, htSlot->key, strSetSlotHash(strSet, smallSet, htSlot));
+        }
+        return strSet;
+    }
+
+    return NULL;
+}
+
+void strSetIterInit(StrSet *strSet, StrSetIterator *strSetIter)
+{
+    if (strSet && strSetIter) {
+        strSetIter->strSet = strSet;
+        strSetIter->idx = 0;
+        strSetIter->version = strSet->version;
+    }
+}
+
+bool strSetIterNext(StrSetIterator *strSetIter, const char **key)
+{
+    /* The hash set must not be modified after the iterator initialization. */
+    if (strSetIter && strSetIter->strSet && strSetIter->version == strSetIter->strSet->version) {
+        StrSet *strSet = strSetIter->strSet;
+        StrSetSlot *htSlots = strSet->htSlots;
+        for (; strSetIter->idx < strSet->capacity; strSetIter->idx++) {
+            if (htSlots[strSetIter->idx].key) {
+                if (key)
+                    *key = htSlots[strSetIter->idx].key;
+                strSetIter->idx++;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
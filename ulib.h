@@ -42,20 +42,68 @@
 /* TYPES */
 
 /** @struct Array
- *  @brief This structure contains the data to handle an array of generic pointers.
+ *  @brief This structure contains the data to handle an array of generic pointers.<br>
+ *  When it is full, the capacity is doubled so adding N elements costs O(log N) reallocations.
  *  @var Array::arr
  *  It represents the real array of generic pointers.
  *  @var Array::size
  *  It represents the size of 'arr' members
  *  @var Array::releaseFn
  *  It represents a generic pointer to release function.
+ *  @var Array::capacity
+ *  It represents the number of the allocated 'arr' members.
  */
 typedef struct {
     void **arr;
     int size;
     void (*releaseFn)(void **);
+    int capacity;
 } Array;
 
+/** @def SEG_ARRAY_CHUNK_SHIFT
+ *  The number of the elements of a segmented array chunk is 2^SEG_ARRAY_CHUNK_SHIFT.
+ */
+#define SEG_ARRAY_CHUNK_SHIFT 10
+
+/** @struct SegArray
+ *  @brief This structure represents a segmented array.<br>
+ *  The elements are stored by value into fixed-size chunks indexed by a directory,<br>
+ *  so they are never moved and their addresses are valid until they are removed.
+ *  @var SegArray::chunks
+ *  It represents the directory of the chunks.
+ *  @var SegArray::size
+ *  It represents the number of the elements.
+ *  @var SegArray::numOfChunks
+ *  It represents the number of the allocated chunks.
+ *  @var SegArray::chunksCapacity
+ *  It represents the number of the allocated 'chunks' members.
+ *  @var SegArray::elementSize
+ *  It represents the size in bytes of an element.
+ *  @var SegArray::releaseFn
+ *  It represents the function to release an element, it receives the element address.
+ */
+typedef struct {
+    void **chunks;
+    int size;
+    int numOfChunks;
+    int chunksCapacity;
+    int elementSize;
+    void (*releaseFn)(void *);
+} SegArray;
+
+/** @struct SegArrayIterator
+ *  @brief This structure represents a segmented array iterator.<br>
+ *  It is initialized on the stack by segArrayIterInit() function.
+ *  @var SegArrayIterator::segArray
+ *  It represents the segmented array.
+ *  @var SegArrayIterator::idx
+ *  It represents the index of the next element.
+ */
+typedef struct {
+    SegArray *segArray;
+    int idx;
+} SegArrayIterator;
+
 /** @struct Time
  *  @brief This structure represents a simple calendar time, or an elapsed time, with milliseconds resolution.
  *  @var Time::sec
@@ -74,8 +122,74 @@ typedef struct {
     long *durationMillisec;
 } Time;
 
+/** @enum HtType
+ *  @brief This enumeration represents the hash table engine.
+ *  @var HT_CHAINED
+ *  Separate chaining: every hash entry holds an array of items.
+ *  @var HT_FLAT
+ *  Open addressing with Robin Hood probing: hash, key and value of every item
+ *  are stored inline into a single contiguous array of slots.
+ */
+typedef enum { HT_CHAINED = 0, HT_FLAT = 1 } HtType;
+
+/** @enum HtKeyMode
+ *  @brief This enumeration represents how a hash table handles the keys memory.
+ *  @var HT_KEY_COPY
+ *  Every key is copied when it is added and freed when it is removed (default).
+ *  @var HT_KEY_BORROW
+ *  The keys are not copied: the caller owns them and must keep them alive and unchanged<br>
+ *  as long as they are into the hash table (static strings, parser buffers, ...).
+ *  @var HT_KEY_INTERN
+ *  The keys are stored once into a pool shared by all the HT_KEY_INTERN hash tables<br>
+ *  and released when no hash table uses them anymore.
+ */
+typedef enum { HT_KEY_COPY = 0, HT_KEY_BORROW = 1, HT_KEY_INTERN = 2 } HtKeyMode;
+
+/** @struct HtPolicy
+ *  @brief This structure represents the resize policy of a hash table.
+ *  @var HtPolicy::growLoadFactor
+ *  The hash table will grow when the load factor achieves this value (default 0.75).<br>
+ *  It must be less than 1 for the HT_FLAT hash tables.
+ *  @var HtPolicy::shrinkLoadFactor
+ *  The hash table will shrink when the load factor achieves this value (default 0.25).<br>
+ *  It must be less than the half of the grow load factor so a resize never triggers<br>
+ *  the opposite one (hysteresis).
+ *  @var HtPolicy::minCapacity
+ *  The hash table capacity will be never less than this value.<br>
+ *  Zero means the initial capacity.
+ *  @var HtPolicy::shrinkDisabled
+ *  If true, the hash table will never shrink automatically.
+ */
+typedef struct {
+    float growLoadFactor;
+    float shrinkLoadFactor;
+    int minCapacity;
+    bool shrinkDisabled;
+} HtPolicy;
+
+/** @struct HtCounters
+ *  @brief This structure represents the counters of the hash table operations.<br>
+ *  They are updated only if the library is built with the HT_STATS meson option,<br>
+ *  otherwise they are always zero and cost nothing.
+ *  @var HtCounters::hits
+ *  It represents the number of the lookups which found the key.
+ *  @var HtCounters::misses
+ *  It represents the number of the lookups which didn't find the key.
+ *  @var HtCounters::numOfResizes
+ *  It represents the number of the resizes (grow, shrink or reserve).
+ *  @var HtCounters::resizeTime
+ *  It represents the time spent to move the items by the resizes (nanoseconds).
+ */
+typedef struct {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t numOfResizes;
+    uint64_t resizeTime;
+} HtCounters;
+
 /** @struct Ht
- *  @brief This structure represents a dynamic hash table with separate chaining.
+ *  @brief This structure represents a dynamic hash table.<br>
+ *  According the type, it uses the separate chaining or the open addressing (flat).<br>
  *  @brief <b>Key addition management</b>.<br>
  *  When the keys will achieve the 3/4 of the hash table capacity (<i>load factor 0.75</i>),<br>
  *  the latter will grow with the double of the previous capacity<br>
@@ -84,33 +198,119 @@ typedef struct {
  *  When the keys will achieve the 1/4 of the hash table capacity (<i>load factor 0.25</i>),<br>
  *  the latter will be the half of the previous size<br>
  *  to optimize memory usage.<br><br>
+ *  Both the load factors can be changed by a HtPolicy structure (see htNewWithPolicy()).<br>
  *  For both, a key rehashing will be performed.<br>
- *  The current capacity will be never less than the initial capacity.
+ *  The hash table structure is never replaced, only its hash entries,<br>
+ *  thus a pointer to the hash table remains valid across the additions and remotions.<br>
+ *  If a rehash step is set (HT_CHAINED only), the rehashing is incremental:<br>
+ *  the old and the new hash entries live together and every addition or remotion<br>
+ *  moves only 'rehashStep' old hash entries, so no single call performs O(n) work.<br>
+ *  The current capacity will be never less than the minimum capacity of the policy<br>
+ *  which is the initial capacity by default.<br>
+ *  The capacity is always a power of 2 and every item stores the 64 bit hash of its key,<br>
+ *  so the rehashing never reads the keys again.
+ *  @var Ht::type
+ *  It represents the hash table engine.
  *  @var Ht::initialCapacity
  *  It represents the initial hash table capacity.
  *  @var Ht::capacity
  *  It represents the hash table capacity.
  *  @var Ht::numOfItems
  *  It represents the number of the hash table items.
+ *  @var Ht::seed
+ *  It represents the seed of the hash function.
  *  @var Ht::htEntries
- *  It represents an array of HtEntry structure.
+ *  It represents the array of HtEntry structure (HT_CHAINED only).
+ *  @var Ht::htOldEntries
+ *  It represents the old array of HtEntry structure during an incremental rehashing.
+ *  @var Ht::oldCapacity
+ *  It represents the old hash table capacity during an incremental rehashing.
+ *  @var Ht::rehashIdx
+ *  It represents the index of the next old hash entry to move.
+ *  @var Ht::rehashStep
+ *  It represents the number of old hash entries moved for every addition or remotion.<br>
+ *  Zero means that the rehashing is performed at once.
+ *  @var Ht::htSlots
+ *  It represents the array of HtItem structure (HT_FLAT only).
  *  @var Ht::releaseFn
  *  It represents a generic pointer to release function.
+ *  @var Ht::keyMode
+ *  It represents how the keys memory is handled.
+ *  @var Ht::policy
+ *  It represents the resize policy.
+ *  @var Ht::version
+ *  It represents the modification counter.<br>
+ *  It changes whenever an item is added or removed or the hash entries are moved.
  *  @var Ht::totCollisions
  *  It represents the total collisions number.
  *  @var Ht::maxCollisionsForEntry
  *  It represents the maximum collisions number for entry.
+ *  @var Ht::counters
+ *  It represents the operation counters (see HtCounters).
  */
 typedef struct {
+    HtType type;
     int initialCapacity;
     int capacity;
     int numOfItems;
-    Array *htEntries;
+    uint64_t seed;
+    void *htEntries;
+    void *htOldEntries;
+    int oldCapacity;
+    int rehashIdx;
+    int rehashStep;
+    void *htSlots;
     void (*releaseFn)(void **);
+    HtKeyMode keyMode;
+    HtPolicy policy;
+    unsigned int version;
     int totCollisions;
     int maxCollisionsForEntry;
+    HtCounters counters;
 } Ht;
 
+/* Number of the probe length histogram buckets, the last one counts the longer probes too. */
+#define HT_STATS_HISTOGRAM_SIZE 16
+
+/** @struct HtStats
+ *  @brief This structure represents the statistics of a hash table (see htGetStats()).<br>
+ *  The probe length of an item is the number of the items examined before it by a lookup:<br>
+ *  its position into the hash entry (HT_CHAINED) or its distance from the home slot (HT_FLAT).
+ *  @var HtStats::numOfItems
+ *  It represents the number of the items.
+ *  @var HtStats::capacity
+ *  It represents the capacity.
+ *  @var HtStats::loadFactor
+ *  It represents the load factor.
+ *  @var HtStats::probeHistogram
+ *  It represents the number of the items for every probe length.
+ *  @var HtStats::maxProbeLength
+ *  It represents the maximum probe length.
+ *  @var HtStats::avgProbeLength
+ *  It represents the average probe length.
+ *  @var HtStats::bucketBytes
+ *  It represents the bytes used by the hash entries or by the slots.
+ *  @var HtStats::itemBytes
+ *  It represents the bytes used by the items arrays of the hash entries (HT_CHAINED only).
+ *  @var HtStats::keyBytes
+ *  It represents the bytes used by the keys owned by the hash table<br>
+ *  (HT_KEY_COPY keys which are not stored into the items).
+ *  @var HtStats::counters
+ *  It represents the operation counters.
+ */
+typedef struct {
+    int numOfItems;
+    int capacity;
+    float loadFactor;
+    int probeHistogram[HT_STATS_HISTOGRAM_SIZE];
+    int maxProbeLength;
+    double avgProbeLength;
+    size_t bucketBytes;
+    size_t itemBytes;
+    size_t keyBytes;
+    HtCounters counters;
+} HtStats;
+
 /** @struct HtIterator
  *  @brief This structure represents a hash table iterator.
  *  @var HtIterator::ht
@@ -119,13 +319,282 @@ typedef struct {
  *  It represents the hash table key index.
  *  @var HtIterator::hashItemIdx
  *  It represents the hash table item index.
+ *  @var HtIterator::version
+ *  It represents the hash table modification counter when the iteration started.
+ *  @var HtIterator::startIdx
+ *  It represents the first visited slot (HT_FLAT only), it follows an empty slot<br>
+ *  so the removals never move an item before the current one.
+ *  @var HtIterator::removed
+ *  It represents true if some item has been removed by htIterRemove() function.
+ *  @var HtIterator::current
+ *  It represents true if the item returned by the last htIterNext() call can be removed.
  */
 typedef struct {
     Ht *ht;
     int hashIdx;
     int hashItemIdx;
+    unsigned int version;
+    int startIdx;
+    bool removed;
+    bool current;
 } HtIterator;
 
+/** @struct HtFrozen
+ *  @brief This structure represents a read-only hash table built by htFreeze() function.<br>
+ *  A minimal perfect hash function maps every key to its own slot, thus a lookup<br>
+ *  performs exactly one probe and there are no collisions.<br>
+ *  The keys are stored into a single contiguous blob, null-terminated,<br>
+ *  and the slot of a key is also its iteration index.
+ *  @var HtFrozen::numOfItems
+ *  It represents the number of the items, which is also the number of the slots.
+ *  @var HtFrozen::numOfBuckets
+ *  It represents the number of the buckets of the perfect hash function.
+ *  @var HtFrozen::seed
+ *  It represents the seed of the hash function.
+ *  @var HtFrozen::pilots
+ *  It represents the displacement of every bucket.
+ *  @var HtFrozen::keys
+ *  It represents the keys blob.
+ *  @var HtFrozen::keyOffsets
+ *  It represents the offset of every key into the keys blob (numOfItems + 1 offsets).
+ *  @var HtFrozen::values
+ *  It represents the values array.
+ *  @var HtFrozen::releaseFn
+ *  It represents a generic pointer to release function.
+ */
+typedef struct {
+    int numOfItems;
+    int numOfBuckets;
+    uint64_t seed;
+    uint32_t *pilots;
+    char *keys;
+    uint32_t *keyOffsets;
+    void **values;
+    void (*releaseFn)(void **);
+} HtFrozen;
+
+/** @struct HtMapped
+ *  @brief This structure represents a frozen hash table snapshot mapped in memory.<br>
+ *  The lookups are performed directly on the mapped file, nothing is deserialized.<br>
+ *  All the pointers point into the mapped file.
+ *  @var HtMapped::numOfItems
+ *  It represents the number of the items.
+ *  @var HtMapped::numOfBuckets
+ *  It represents the number of the buckets of the perfect hash function.
+ *  @var HtMapped::seed
+ *  It represents the seed of the hash function.
+ *  @var HtMapped::pilots
+ *  It represents the displacement of every bucket.
+ *  @var HtMapped::keys
+ *  It represents the keys blob.
+ *  @var HtMapped::keyOffsets
+ *  It represents the offset of every key into the keys blob (numOfItems + 1 offsets).
+ *  @var HtMapped::values
+ *  It represents the values blob.
+ *  @var HtMapped::valueOffsets
+ *  It represents the offset and the size of every value into the values blob<br>
+ *  (2 * numOfItems numbers).
+ *  @var HtMapped::map
+ *  It represents the mapped file.
+ *  @var HtMapped::mapSize
+ *  It represents the mapped file size.
+ */
+typedef struct {
+    int numOfItems;
+    int numOfBuckets;
+    uint64_t seed;
+    const uint32_t *pilots;
+    const char *keys;
+    const uint32_t *keyOffsets;
+    const char *values;
+    const uint64_t *valueOffsets;
+    void *map;
+    size_t mapSize;
+} HtMapped;
+
+/** @struct HtConcurrent
+ *  @brief This structure represents a thread safe hash table.<br>
+ *  The keys are partitioned across the shards by their hash and every shard is a hash table<br>
+ *  protected by its own readers/writer lock.<br>
+ *  The threads which use different shards never wait each other<br>
+ *  and the readers of the same shard run in parallel.
+ *  @var HtConcurrent::numOfShards
+ *  It represents the number of the shards (power of 2).
+ *  @var HtConcurrent::seed
+ *  It represents the seed of the hash function shared by all the shards.
+ *  @var HtConcurrent::htShards
+ *  It represents the array of HtShard structure.
+ */
+typedef struct {
+    int numOfShards;
+    uint64_t seed;
+    void *htShards;
+} HtConcurrent;
+
+/** @struct HtRcu
+ *  @brief This structure represents a read-mostly thread safe hash table.<br>
+ *  The lookups never wait and perform no atomic read-modify-write operation.<br>
+ *  Every modification publishes a modified copy of the hash table and releases the previous<br>
+ *  one, with the removed or replaced values, when no lookup can use it anymore.<br>
+ *  A modification costs O(n), thus it fits the tables built once and rarely updated.
+ *  @var HtRcu::ht
+ *  It represents the published hash table.
+ *  @var HtRcu::epoch
+ *  It represents the current epoch, incremented for every publication.
+ *  @var HtRcu::htRcuSync
+ *  It represents the HtRcuSync structure.
+ */
+typedef struct {
+    Ht *ht;
+    uint64_t epoch;
+    void *htRcuSync;
+} HtRcu;
+
+/** @struct HtInt
+ *  @brief This structure represents a hash table whose keys are 64 bit integers.<br>
+ *  It uses the open addressing with Robin Hood probing and an integer mixer as hash function,<br>
+ *  so no key is formatted, copied or hashed as a string.<br>
+ *  It grows and shrinks according to its resize policy, as the Ht hash table.
+ *  @var HtInt::initialCapacity
+ *  It represents the initial capacity.
+ *  @var HtInt::capacity
+ *  It represents the capacity (power of 2).
+ *  @var HtInt::numOfItems
+ *  It represents the number of the items.
+ *  @var HtInt::htSlots
+ *  It represents the array of HtIntSlot structure.
+ *  @var HtInt::releaseFn
+ *  It represents a generic pointer to release function.
+ *  @var HtInt::version
+ *  It represents the modification counter.
+ *  @var HtInt::policy
+ *  It represents the resize policy.
+ */
+typedef struct {
+    int initialCapacity;
+    int capacity;
+    int numOfItems;
+    void *htSlots;
+    void (*releaseFn)(void **);
+    unsigned int version;
+    HtPolicy policy;
+} HtInt;
+
+/** @struct HtPtr
+ *  @brief This structure represents a hash table whose keys are pointers compared by identity.<br>
+ *  It is a HtInt hash table whose keys are the pointer addresses.
+ */
+typedef HtInt HtPtr;
+
+/** @struct HtIntIterator
+ *  @brief This structure represents an iterator of a HtInt or HtPtr hash table.<br>
+ *  It is initialized on the stack by htIntIterInit() or htPtrIterInit() function.
+ *  @var HtIntIterator::htInt
+ *  It represents the associated hash table.
+ *  @var HtIntIterator::idx
+ *  It represents the index of the next slot.
+ *  @var HtIntIterator::version
+ *  It represents the hash table modification counter when the iteration started.
+ */
+typedef struct {
+    HtInt *htInt;
+    int idx;
+    unsigned int version;
+} HtIntIterator;
+
+/** @struct StrSet
+ *  @brief This structure represents a hash set of strings.<br>
+ *  It stores only the keys, hashed as the Ht keys, into a single array of slots<br>
+ *  (open addressing with Robin Hood probing).<br>
+ *  It grows and shrinks according to its resize policy, as the Ht hash table.
+ *  @var StrSet::initialCapacity
+ *  It represents the initial capacity.
+ *  @var StrSet::capacity
+ *  It represents the capacity (power of 2).
+ *  @var StrSet::numOfItems
+ *  It represents the number of the keys.
+ *  @var StrSet::seed
+ *  It represents the seed of the hash function.
+ *  @var StrSet::htSlots
+ *  It represents the array of StrSetSlot structure.
+ *  @var StrSet::version
+ *  It represents the modification counter.
+ *  @var StrSet::policy
+ *  It represents the resize policy.
+ */
+typedef struct {
+    int initialCapacity;
+    int capacity;
+    int numOfItems;
+    uint64_t seed;
+    void *htSlots;
+    unsigned int version;
+    HtPolicy policy;
+} StrSet;
+
+/** @struct StrSetIterator
+ *  @brief This structure represents an iterator of a StrSet hash set.<br>
+ *  It is initialized on the stack by strSetIterInit() function.
+ *  @var StrSetIterator::strSet
+ *  It represents the associated hash set.
+ *  @var StrSetIterator::idx
+ *  It represents the index of the next slot.
+ *  @var StrSetIterator::version
+ *  It represents the hash set modification counter when the iteration started.
+ */
+typedef struct {
+    StrSet *strSet;
+    int idx;
+    unsigned int version;
+} StrSetIterator;
+
+/** @struct OrdMap
+ *  @brief This structure represents an ordered map (B+ tree).<br>
+ *  The items are kept sorted by key (strcmp order), so the ordered iteration,<br>
+ *  the range scans and the prefix scans cost O(log n + k).<br>
+ *  The keys are copied, the values follow the same ownership model of the hash table.
+ *  @var OrdMap::numOfItems
+ *  It represents the number of the items.
+ *  @var OrdMap::root
+ *  It represents the root node.
+ *  @var OrdMap::releaseFn
+ *  It represents the function to release the values.
+ *  @var OrdMap::version
+ *  It represents the version, incremented for every addition or remotion.
+ */
+typedef struct {
+    int numOfItems;
+    void *root;
+    void (*releaseFn)(void **);
+    unsigned int version;
+} OrdMap;
+
+/** @struct OrdMapIterator
+ *  @brief This structure represents an ordered map iterator.<br>
+ *  It is initialized on the stack by ordMapIterFirst(), ordMapIterLowerBound()<br>
+ *  or ordMapIterPrefix() functions and it is invalidated by any addition or remotion.
+ *  @var OrdMapIterator::ordMap
+ *  It represents the ordered map.
+ *  @var OrdMapIterator::node
+ *  It represents the current leaf.
+ *  @var OrdMapIterator::idx
+ *  It represents the index of the next item into the current leaf.
+ *  @var OrdMapIterator::prefix
+ *  It represents the prefix which the keys must start with (optional).
+ *  @var OrdMapIterator::prefixLen
+ *  It represents the prefix length.
+ *  @var OrdMapIterator::version
+ *  It represents the ordered map version at the initialization.
+ */
+typedef struct {
+    OrdMap *ordMap;
+    void *node;
+    int idx;
+    const char *prefix;
+    size_t prefixLen;
+    unsigned int version;
+} OrdMapIterator;
+
 // PARSER SECTIONS
 /** @struct Section
  *  @brief This structure represents a file section.
@@ -627,6 +1096,45 @@ bool arrayRemove(Array *arr, void *ptr);
  */
 void arrayRelease(Array **arr);
 
+/**
+ * Return true if the element at the 'idx' position is removed from 'arr' array, false otherwise.<br>
+ * The last element takes its place, so it costs O(1) but the elements order is not kept.
+ * @param[in] arr
+ * @param[in] idx
+ * @return true/false
+ */
+bool arraySwapRemoveAt(Array *arr, int idx);
+
+/**
+ * Return true if the 'count' elements starting from the 'idx' position are removed<br>
+ * from 'arr' array, false otherwise.<br>
+ * The following elements are moved once.
+ * @param[in] arr
+ * @param[in] idx
+ * @param[in] count
+ * @return true/false
+ */
+bool arrayRemoveRange(Array *arr, int idx, int count);
+
+/**
+ * Remove from 'arr' array the elements for which 'predicateFn' function returns true<br>
+ * in a single pass, keeping the order of the others.<br>
+ * The 'predicateFn' function receives the element and the 'data' parameter.<br>
+ * Return the number of the removed elements.
+ * @param[in] arr
+ * @param[in] predicateFn
+ * @param[in] data
+ * @return integer
+ */
+int arrayRemoveIf(Array *arr, bool (*predicateFn)(void *, void *), void *data);
+
+/**
+ * Remove all the elements of 'arr' array in a single pass.<br>
+ * The capacity is not changed.
+ * @param[in] arr
+ */
+void arrayClear(Array *arr);
+
 /**
  * Return true if the 'element' is set into 'arr' array at the 'idx' position, false otherwise.<br>
  * @param[in] arr
@@ -668,6 +1176,284 @@ void *arrayGet(Array *arr, int idx);
  */
 int arrayGetIdx(Array *arr, void *element);
 
+/**
+ * Return true if the 'arr' array capacity is at least 'capacity' elements, false otherwise.<br>
+ * The next additions will not reallocate the array until the capacity is reached.
+ * @param[in] arr
+ * @param[in] capacity
+ * @return true/false
+ */
+bool arrayReserve(Array *arr, int capacity);
+
+/**
+ * Return true if the 'arr' array capacity is reduced to its size, false otherwise.
+ * @param[in] arr
+ * @return true/false
+ */
+bool arrayShrinkToFit(Array *arr);
+
+/**
+ * Return true if the 'arr' array is sorted by the 'compareFn' function, false otherwise.<br>
+ * The 'compareFn' function receives two elements and returns a negative number, zero<br>
+ * or a positive number if the first element is less, equal or greater than the second one.<br>
+ * It is an introsort: O(n log n) in the worst case, the equal elements could be reordered.
+ * @param[in] arr
+ * @param[in] compareFn
+ * @return true/false
+ */
+bool arraySort(Array *arr, int (*compareFn)(const void *, const void *));
+
+/**
+ * Same of arraySort() function but the equal elements keep their order (merge sort).<br>
+ * It allocates a temporary buffer of the array size.
+ * @param[in] arr
+ * @param[in] compareFn
+ * @return true/false
+ */
+bool arrayStableSort(Array *arr, int (*compareFn)(const void *, const void *));
+
+/**
+ * Return the index of the first element equal to 'element' into the 'arr' array<br>
+ * sorted by the 'compareFn' function, -1 otherwise.<br>
+ * It costs O(log n).
+ * @param[in] arr
+ * @param[in] element
+ * @param[in] compareFn
+ * @return integer
+ */
+int arrayBinarySearch(Array *arr, const void *element,
+                      int (*compareFn)(const void *, const void *));
+
+/**
+ * Insert the 'element' into the 'arr' array sorted by the 'compareFn' function<br>
+ * after the equal elements, so the array remains sorted.<br>
+ * Return the index of the element, -1 otherwise.
+ * @param[in] arr
+ * @param[in] element
+ * @param[in] compareFn
+ * @return integer
+ */
+int arrayInsertSorted(Array *arr, void *element, int (*compareFn)(const void *, const void *));
+
+/**
+ * Return true if the 'arr' array of strings is sorted (strcmp order, NULL first),<br>
+ * false otherwise.<br>
+ * The string lengths are computed once, so the comparisons don't look for the terminator.
+ * @param[in] arr
+ * @return true/false
+ */
+bool arraySortStr(Array *arr);
+
+/**
+ * Return the index of the 'str' string into the 'arr' array sorted by arraySortStr() function,<br>
+ * -1 otherwise.<br>
+ * It costs O(log n), unlike arrayContainsStr() function.
+ * @param[in] arr
+ * @param[in] str
+ * @return integer
+ */
+int arrayBinarySearchStr(Array *arr, const char *str);
+
+/**
+ * Insert the 'str' string into the 'arr' array sorted by arraySortStr() function.<br>
+ * The string is not copied, as for arrayAdd() function.<br>
+ * Return the index of the string, -1 otherwise.
+ * @param[in] arr
+ * @param[in] str
+ * @return integer
+ */
+int arrayInsertSortedStr(Array *arr, char *str);
+
+/**
+ * Define a typed array 'Name' which stores the elements of 'Type' type by value<br>
+ * into a single contiguous allocation, and its functions prefixed by 'prefix':<br>
+ * <ul>
+ * <li>Name *prefixNew(void (*releaseFn)(Type *)) the release function is optional</li>
+ * <li>void prefixRelease(Name **arr)</li>
+ * <li>bool prefixAdd(Name *arr, Type element)</li>
+ * <li>bool prefixInsertAt(Name *arr, int idx, Type element)</li>
+ * <li>bool prefixRemoveAt(Name *arr, int idx)</li>
+ * <li>bool prefixSet(Name *arr, Type element, int idx)</li>
+ * <li>Type *prefixGet(Name *arr, int idx) NULL if the index is out of range</li>
+ * <li>bool prefixReserve(Name *arr, int capacity)</li>
+ * <li>bool prefixShrinkToFit(Name *arr)</li>
+ * </ul>
+ * The functions behave as the Array ones, the release function receives the element address.<br>
+ * The element addresses are invalidated by the additions and the insertions.<br>
+ * Example: ARRAY_DEFINE(IntArray, intArray, int)
+ */
+#define ARRAY_DEFINE(Name, prefix, Type)                                                     \
+    typedef struct {                                                                         \
+        Type *arr;                                                                           \
+        int size;                                                                            \
+        void (*releaseFn)(Type *);                                                           \
+        int capacity;                                                                        \
+    } Name;                                                                                  \
+                                                                                             \
+    static inline void prefix##SetCapacity(Name *array, int capacity)                        \
+    {                                                                                        \
+        Type *arr = realloc(array->arr, (capacity > 0 ? capacity : 1) * sizeof(Type));       \
+        assert(arr);                                                                         \
+        array->arr = arr;                                                                    \
+        array->capacity = capacity;                                                          \
+    }                                                                                        \
+                                                                                             \
+    static inline Name *prefix##New(void (*releaseFn)(Type *))                               \
+    {                                                                                        \
+        Name *array = calloc(1, sizeof(Name));                                               \
+        assert(array);                                                                       \
+        array->releaseFn = releaseFn;                                                        \
+        return array;                                                                        \
+    }                                                                                        \
+                                                                                             \
+    static inline void prefix##Release(Name **array)                                         \
+    {                                                                                        \
+        if (*array) {                                                                        \
+            if ((*array)->releaseFn) {                                                       \
+                for (int i = 0; i < (*array)->size; i++)                                     \
+                    (*(*array)->releaseFn)(&(*array)->arr[i]);                               \
+            }                                                                                \
+            free((*array)->arr);                                                             \
+            free(*array);                                                                    \
+            *array = NULL;                                                                   \
+        }                                                                                    \
+    }                                                                                        \
+                                                                                             \
+    static inline bool prefix##InsertAt(Name *array, int idx, Type element)                  \
+    {                                                                                        \
+        if (array && idx >= 0 && idx <= array->size) {                                       \
+            if (array->size == array->capacity)                                              \
+                prefix##SetCapacity(array, array->capacity > 0 ? array->capacity * 2 : 4);   \
+            memmove(array->arr + idx + 1, array->arr + idx,                                  \
+                    (array->size - idx) * sizeof(Type));                                     \
+            array->arr[idx] = element;                                                       \
+            array->size++;                                                                   \
+            return true;                                                                     \
+        }                                                                                    \
+        return false;                                                                        \
+    }                                                                                        \
+                                                                                             \
+    static inline bool prefix##Add(Name *array, Type element)                                \
+    {                                                                                        \
+        return array ? prefix##InsertAt(array, array->size, element) : false;                \
+    }                                                                                        \
+                                                                                             \
+    static inline bool prefix##RemoveAt(Name *array, int idx)                                \
+    {                                                                                        \
+        if (array && idx >= 0 && idx < array->size) {                                        \
+            if (array->releaseFn)                                                            \
+                (*array->releaseFn)(&array->arr[idx]);                                       \
+            memmove(array->arr + idx, array->arr + idx + 1,                                  \
+                    (array->size - idx - 1) * sizeof(Type));                                 \
+            array->size--;                                                                   \
+            return true;                                                                     \
+        }                                                                                    \
+        return false;                                                                        \
+    }                                                                                        \
+                                                                                             \
+    static inline bool prefix##Set(Name *array, Type element, int idx)                       \
+    {                                                                                        \
+        if (array && idx >= 0 && idx < array->size) {                                        \
+            if (array->releaseFn)                                                            \
+                (*array->releaseFn)(&array->arr[idx]);                                       \
+            array->arr[idx] = element;                                                       \
+            return true;                                                                     \
+        }                                                                                    \
+        return false;                                                                        \
+    }                                                                                        \
+                                                                                             \
+    static inline Type *prefix##Get(Name *array, int idx)                                    \
+    {                                                                                        \
+        return array && idx >= 0 && idx < array->size ? &array->arr[idx] : NULL;            \
+    }                                                                                        \
+                                                                                             \
+    static inline bool prefix##Reserve(Name *array, int capacity)                            \
+    {                                                                                        \
+        if (array && capacity >= 0) {                                                        \
+            if (capacity > array->capacity)                                                  \
+                prefix##SetCapacity(array, capacity);                                        \
+            return true;                                                                     \
+        }                                                                                    \
+        return false;                                                                        \
+    }                                                                                        \
+                                                                                             \
+    static inline bool prefix##ShrinkToFit(Name *array)                                      \
+    {                                                                                        \
+        if (array) {                                                                         \
+            if (array->size < array->capacity)                                               \
+                prefix##SetCapacity(array, array->size);                                     \
+            return true;                                                                     \
+        }                                                                                    \
+        return false;                                                                        \
+    }
+
+// SEGARRAY
+
+/**
+ * Return an empty segmented array whose elements have the size given by 'elementSize'.<br>
+ * The release function is optional, it receives the element address<br>
+ * and it is called when the element is removed or the whole array is released.<br>
+ * It must be freed by segArrayRelease() function.
+ * @param[in] elementSize
+ * @param[in] releaseFn
+ * @return SegArray
+ */
+SegArray *segArrayNew(int elementSize, void (*releaseFn)(void *));
+
+/**
+ * Free a segmented array and its elements if the release function is defined.
+ * @param[in] segArray
+ */
+void segArrayRelease(SegArray **segArray);
+
+/**
+ * Append a copy of the element to the segmented array and return its address.<br>
+ * If 'element' is NULL then the new element is zeroed.<br>
+ * It costs amortized O(1), the other elements are never moved.
+ * @param[in] segArray
+ * @param[in] element
+ * @return void*
+ */
+void *segArrayAdd(SegArray *segArray, const void *element);
+
+/**
+ * Return the address of the element at the 'idx' position or NULL if the index is out of range.<br>
+ * It costs O(1).
+ * @param[in] segArray
+ * @param[in] idx
+ * @return void*
+ */
+void *segArrayGet(SegArray *segArray, int idx);
+
+/**
+ * Return true if the last element is removed from the segmented array, false otherwise.
+ * @param[in] segArray
+ * @return true/false
+ */
+bool segArrayRemoveLast(SegArray *segArray);
+
+/**
+ * Remove all the elements of the segmented array, the chunks are kept to be reused.
+ * @param[in] segArray
+ */
+void segArrayClear(SegArray *segArray);
+
+/**
+ * Initialize the iterator to the first element.
+ * @param[in] segArray
+ * @param[out] segArrayIter
+ */
+void segArrayIterInit(SegArray *segArray, SegArrayIterator *segArrayIter);
+
+/**
+ * Get the address of the next element.<br>
+ * Return false at the end of the iteration.
+ * @param[in] segArrayIter
+ * @param[out] element
+ * @return true/false
+ */
+bool segArrayIterNext(SegArrayIterator *segArrayIter, void **element);
+
 /* DATE AND TIME  */
 
 /**
@@ -729,15 +1515,75 @@ char *stringGetDiffTime(Time *timeEnd, Time *timeStart);
  * when we remove or set the element or when we release the whole hash table.<br>
  * It's optional thus can accept NULL value.<br>
  * It must be freed by htRelease() function.<br>
- * About the initial capacity, it is highly recommended set a number<br>
- * which must not represent a power of 2 to avoid the collisions as much as possible.<br>
- * A prime number is preferable.<br>
+ * The initial capacity is rounded up to the next power of 2.<br>
  * @param[in] initialCapacity
  * @param[in] releaseFn
  * @return Ht
  */
 Ht *htNew(int initialCapacity, void (*releaseFn)(void **));
 
+/**
+ * Return a flat hash table (open addressing).<br>
+ * The items are stored inline into a single contiguous array of slots<br>
+ * so a lookup usually touches only one cache line.<br>
+ * The release function pointer has the same meaning of htNew() function.<br>
+ * The initial capacity is rounded up to the next power of 2.<br>
+ * It must be freed by htRelease() function.<br>
+ * @param[in] initialCapacity
+ * @param[in] releaseFn
+ * @return Ht
+ */
+Ht *htNewFlat(int initialCapacity, void (*releaseFn)(void **));
+
+/**
+ * Return a hash table of 'type' type which contains the 'numOfItems' items<br>
+ * of the 'keys' and 'values' arrays (the value of keys[i] is values[i]).<br>
+ * The capacity is allocated once, all the keys are hashed in a single loop<br>
+ * and every hash entry is allocated once.<br>
+ * The initial capacity is given by 'numOfItems' and the hash table follows the resize policy<br>
+ * given by 'policy' (see htNewWithPolicy()), NULL means the default one.<br>
+ * If 'checkDup' is true, NULL is returned when a key is duplicated; otherwise the keys<br>
+ * must be unique and they are not compared.<br>
+ * NULL is returned as well when a key is null or empty or the policy is not valid,<br>
+ * in all these cases the values remain owned by the caller.<br>
+ * The release function pointer has the same meaning of htNew() function.<br>
+ * It must be freed by htRelease() function.
+ * @param[in] type
+ * @param[in] keys
+ * @param[in] values
+ * @param[in] numOfItems
+ * @param[in] releaseFn
+ * @param[in] policy
+ * @param[in] checkDup
+ * @return Ht*
+ */
+Ht *htNewFromArrays(HtType type, const char **keys, void **values, int numOfItems,
+                    void (*releaseFn)(void **), const HtPolicy *policy, bool checkDup);
+
+/**
+ * Return a hash table of the 'type' engine which follows the resize policy given by 'policy'.<br>
+ * If 'policy' is NULL, the default policy is used.<br>
+ * The initial capacity and the release function pointer have the same meaning of htNew() function.<br>
+ * It must be freed by htRelease() function.<br>
+ * Return NULL if the policy is not valid.<br>
+ * @param[in] type
+ * @param[in] initialCapacity
+ * @param[in] releaseFn
+ * @param[in] policy
+ * @return Ht
+ */
+Ht *htNewWithPolicy(HtType type, int initialCapacity, void (*releaseFn)(void **),
+                    const HtPolicy *policy);
+
+/**
+ * Set the seed of the hash function for the hash tables which will be created.<br>
+ * A random seed makes the hash tables resistant to the collision attacks (HashDoS)<br>
+ * when the keys come from untrusted input.<br>
+ * The hash tables already created keep their seed.
+ * @param[in] seed
+ */
+void htSetHashSeed(uint64_t seed);
+
 /**
  * Free an Ht structure.<br>
  * If the hash table contains a release function pointer then <br>
@@ -754,6 +1600,31 @@ void htRelease(Ht **ht);
  */
 void *htGet(Ht *ht, const char *key);
 
+/**
+ * Return the value of the key if the first 'len' bytes of 'key' exist as key, NULL otherwise.<br>
+ * The key doesn't need to be null-terminated, thus a slice of a buffer can be used<br>
+ * without copying it.
+ * @param[in] ht
+ * @param[in] key
+ * @param[in] len
+ * @return void*
+ */
+void *htGetN(Ht *ht, const char *key, size_t len);
+
+/**
+ * Return the number of the 'keys' keys which exist into the 'ht' hash table.<br>
+ * The value of every key is stored into the 'values' array at the same index,<br>
+ * NULL if the key doesn't exist.<br>
+ * The keys are hashed in batches and the memory of their hash entries is prefetched<br>
+ * before the lookups, thus a lookup doesn't wait for the memory of the previous one.
+ * @param[in] ht
+ * @param[in] keys
+ * @param[in] numOfKeys
+ * @param[out] values
+ * @return int
+ */
+int htGetMany(Ht *ht, const char **keys, int numOfKeys, void **values);
+
 /**
  * Return true if a generic 'value' pointer is added
  * to the 'ht' hash table with 'key' key, false otherwise.<br>
@@ -763,7 +1634,44 @@ void *htGet(Ht *ht, const char *key);
  * @param[in] value
  * @return true/false
  */
-bool htAdd(Ht **ht, const char *key, void *value);
+bool htAdd(Ht *ht, const char *key, void *value);
+
+/**
+ * Return true if a generic 'value' pointer is added to the 'ht' hash table<br>
+ * with the first 'len' bytes of 'key' as key, false otherwise.<br>
+ * The key doesn't need to be null-terminated, the hash table stores a null-terminated copy.<br>
+ * Null, empty or duplicate keys are not allowed.<br>
+ * @param[in] ht
+ * @param[in] key
+ * @param[in] len
+ * @param[in] value
+ * @return true/false
+ */
+bool htAddN(Ht *ht, const char *key, size_t len, void *value);
+
+/**
+ * Return the value of the 'key' key if it exists, otherwise add 'value' with 'key' key<br>
+ * to the 'ht' hash table and return it.<br>
+ * A single lookup is performed. If 'added' is not NULL, it is set to true if 'value' is added.<br>
+ * NULL is returned for null or empty keys.
+ * @param[in] ht
+ * @param[in] key
+ * @param[in] value
+ * @param[out] added
+ * @return void*
+ */
+void *htGetOrAdd(Ht *ht, const char *key, void *value, bool *added);
+
+/**
+ * Same of htGetOrAdd() function with the first 'len' bytes of 'key' as key.
+ * @param[in] ht
+ * @param[in] key
+ * @param[in] len
+ * @param[in] value
+ * @param[out] added
+ * @return void*
+ */
+void *htGetOrAddN(Ht *ht, const char *key, size_t len, void *value, bool *added);
 
 /**
  * Return true if a 'key' key is removed from 'ht' hash table, false otherwise.<br>
@@ -771,7 +1679,17 @@ bool htAdd(Ht **ht, const char *key, void *value);
  * @param[in] key
  * @return true/false
  */
-bool htRemove(Ht **ht, const char *key);
+bool htRemove(Ht *ht, const char *key);
+
+/**
+ * Return true if the first 'len' bytes of 'key' are removed as key from 'ht' hash table,<br>
+ * false otherwise.<br>
+ * @param[in] ht
+ * @param[in] key
+ * @param[in] len
+ * @return true/false
+ */
+bool htRemoveN(Ht *ht, const char *key, size_t len);
 
 /**
  * Return true if 'value' element is set into 'ht' hash table with 'key' key, false otherwise.<br>
@@ -780,7 +1698,62 @@ bool htRemove(Ht **ht, const char *key);
  * @param[in] value
  * @return true/false
  */
-bool htSet(Ht **ht, const char *key, void *value);
+bool htSet(Ht *ht, const char *key, void *value);
+
+/**
+ * Return true if 'value' element is set into 'ht' hash table with the first 'len' bytes<br>
+ * of 'key' as key, false otherwise.<br>
+ * @param[in] ht
+ * @param[in] key
+ * @param[in] len
+ * @param[in] value
+ * @return true/false
+ */
+bool htSetN(Ht *ht, const char *key, size_t len, void *value);
+
+/**
+ * Return true if the 'keyMode' key mode is set into the 'ht' hash table, false otherwise.<br>
+ * The key mode can be changed only if the hash table is empty.<br>
+ * HT_KEY_BORROW avoids the copy of every key, HT_KEY_INTERN stores only once<br>
+ * the keys which are repeated across the hash tables.<br>
+ * The interned keys pool is thread safe.
+ * @param[in] ht
+ * @param[in] keyMode
+ * @return true/false
+ */
+bool htSetKeyMode(Ht *ht, HtKeyMode keyMode);
+
+/**
+ * Return true if the incremental rehashing is configured for the 'ht' hash table, false otherwise.<br>
+ * Every addition or remotion will move 'rehashStep' hash entries from the old hash entries<br>
+ * to the new ones, thus no single call will perform O(n) work.<br>
+ * Zero disables the incremental rehashing completing an eventual rehashing in progress.<br>
+ * A lookup never moves the hash entries.<br>
+ * It is available for HT_CHAINED hash tables only.
+ * @param[in] ht
+ * @param[in] rehashStep
+ * @return true/false
+ */
+bool htSetRehashStep(Ht *ht, int rehashStep);
+
+/**
+ * Return true if the 'ht' hash table capacity is enough to contain 'numOfItems' items<br>
+ * without any further resize, false otherwise.<br>
+ * The hash table grows at once if needed, thus a bulk load performs no intermediate rehashing.
+ * @param[in] ht
+ * @param[in] numOfItems
+ * @return true/false
+ */
+bool htReserve(Ht *ht, int numOfItems);
+
+/**
+ * Return true if the 'ht' hash table capacity is reduced to the smallest one<br>
+ * which contains the current items, false otherwise.<br>
+ * The capacity will be never less than the minimum capacity of the policy.
+ * @param[in] ht
+ * @return true/false
+ */
+bool htShrinkToFit(Ht *ht);
 
 /**
  * Set data for debug/diagnostic purpose.<br>
@@ -788,6 +1761,22 @@ bool htSet(Ht **ht, const char *key, void *value);
  */
 void htSetDebugData(Ht *ht);
 
+/**
+ * Fill the 'htStats' structure with the statistics of the 'ht' hash table.<br>
+ * The histogram and the memory usage are computed by scanning the hash entries,<br>
+ * the counters are the ones of the hash table (see HtCounters).
+ * @param[in] ht
+ * @param[out] htStats
+ * @return true/false
+ */
+bool htGetStats(Ht *ht, HtStats *htStats);
+
+/**
+ * Reset the operation counters of the 'ht' hash table.
+ * @param[in] ht
+ */
+void htResetCounters(Ht *ht);
+
 /**
  * Return the hast table iterator if 'ht' hash table is not null, NULL otherwise.<br>
  * It must be freed by objectRelease() function.<br>
@@ -797,7 +1786,10 @@ void htSetDebugData(Ht *ht);
 HtIterator *htGetIterator(Ht *ht);
 
 /**
- * Return the value of the next hash table key, NULL if the iterator is terminated.
+ * Return the value of the next hash table key, NULL if the iterator is terminated.<br>
+ * NULL is returned also if the hash table has been modified (added or removed items)<br>
+ * after the iterator creation or reset; it can be detected comparing<br>
+ * HtIterator::version and Ht::version.
  * @param[in] htIterator
  * @return void*
  */
@@ -810,6 +1802,766 @@ void *htGetNext(HtIterator *htIterator);
  */
 void htIteratorReset(Ht *ht, HtIterator *htIterator);
 
+/**
+ * Initialize a hash table iterator allocated by the caller, usually on the stack.<br>
+ * Unlike htGetIterator() function, nothing is allocated and nothing must be freed.
+ * @param[in] ht
+ * @param[out] htIterator
+ */
+void htIterInit(Ht *ht, HtIterator *htIterator);
+
+/**
+ * Get the key and the value of the next hash table item.<br>
+ * Return false if the iterator is terminated or the hash table has been modified<br>
+ * after the iterator creation or reset (htIterRemove() function excluded).<br>
+ * The key is valid until the next modification of the hash table.
+ * @param[in] htIterator
+ * @param[out] key (optional)
+ * @param[out] value (optional)
+ * @return true/false
+ */
+bool htIterNext(HtIterator *htIterator, const char **key, void **value);
+
+/**
+ * Remove the item returned by the last htIterNext() call in O(1)<br>
+ * releasing its value if the release function is defined.<br>
+ * The iteration continues with the next item, every item is visited once.<br>
+ * The hash table is not shrunk until the iteration ends, that is when htIterNext()<br>
+ * returns false; otherwise the shrink is performed by the next removals.<br>
+ * The other iterators of the hash table are invalidated.
+ * @param[in] htIterator
+ * @return true/false
+ */
+bool htIterRemove(HtIterator *htIterator);
+
+/**
+ * Iterate the items of the 'ht' hash table by an iterator on the stack.<br>
+ * The 'key' (const char *) and 'value' variables must be declared by the caller.<br>
+ * The items can be removed by htIterRemove(&htForeachIter).<br>
+ * Example:<br>
+ * <code>HT_FOREACH(ht, key, value) printf("%s\n", key);</code>
+ */
+#define HT_FOREACH(ht, key, value)                                                 \
+    for (HtIterator htForeachIter = { 0 },                                         \
+                    *htForeachIterPtr = (htIterInit((ht), &htForeachIter),         \
+                                         &htForeachIter);                          \
+         htIterNext(htForeachIterPtr, &(key), (void **)&(value));)
+
+/**
+ * Return a read-only hash table which contains the items of the 'ht' hash table.<br>
+ * The values and the release function are moved, the 'ht' hash table is released<br>
+ * and its pointer is set to NULL.<br>
+ * The building time is linear in the number of the items.<br>
+ * It must be freed by htFrozenRelease() function.
+ * @param[in] ht
+ * @return HtFrozen*
+ */
+HtFrozen *htFreeze(Ht **ht);
+
+/**
+ * Release the 'htFrozen' hash table, the values are released by the release function.
+ * @param[in] htFrozen
+ */
+void htFrozenRelease(HtFrozen **htFrozen);
+
+/**
+ * Return the value of the 'key' key if it exists, NULL otherwise.
+ * @param[in] htFrozen
+ * @param[in] key
+ * @return void*
+ */
+void *htFrozenGet(HtFrozen *htFrozen, const char *key);
+
+/**
+ * Return the value of the key if the first 'len' bytes of 'key' exist as key, NULL otherwise.
+ * @param[in] htFrozen
+ * @param[in] key
+ * @param[in] len
+ * @return void*
+ */
+void *htFrozenGetN(HtFrozen *htFrozen, const char *key, size_t len);
+
+/**
+ * Return the value of the item at the 'idx' index, which goes from zero to<br>
+ * HtFrozen::numOfItems - 1, NULL if the index is out of range.<br>
+ * If 'key' is not NULL, it is set to the null-terminated key of the item.
+ * @param[in] htFrozen
+ * @param[in] idx
+ * @param[out] key
+ * @return void*
+ */
+void *htFrozenGetAt(HtFrozen *htFrozen, int idx, const char **key);
+
+/**
+ * Return true if the 'htFrozen' hash table is written into the 'path' file, false otherwise.<br>
+ * The size of every value is given by 'valueSizeFn' function, NULL means that the values<br>
+ * are null-terminated strings (NULL values are written as empty strings).<br>
+ * The NULL values are written as zeros, 'valueSizeFn' function receives them as well.<br>
+ * The file is written into a unique temporary file which replaces it at once.<br>
+ * Every value is aligned to 8 bytes into the file.<br>
+ * The file can be read by htMappedOpen() function on a machine with the same byte order.
+ * @param[in] htFrozen
+ * @param[in] path
+ * @param[in] valueSizeFn
+ * @return true/false
+ */
+bool htFrozenWrite(HtFrozen *htFrozen, const char *path, size_t (*valueSizeFn)(const void *));
+
+/**
+ * Return the hash table snapshot of the 'path' file mapped in memory, NULL if the file<br>
+ * can't be opened or it is not a valid snapshot (version, byte order, size).<br>
+ * It must be freed by htMappedClose() function.
+ * @param[in] path
+ * @return HtMapped*
+ */
+HtMapped *htMappedOpen(const char *path);
+
+/**
+ * Unmap and release the 'htMapped' hash table snapshot.<br>
+ * The values returned by the lookups can't be used anymore.
+ * @param[in] htMapped
+ */
+void htMappedClose(HtMapped **htMapped);
+
+/**
+ * Return the value of the key if the first 'len' bytes of 'key' exist as key, NULL otherwise.<br>
+ * If 'size' is not NULL, it is set to the value size.<br>
+ * The value points into the mapped file.
+ * @param[in] htMapped
+ * @param[in] key
+ * @param[in] len
+ * @param[out] size
+ * @return const void*
+ */
+const void *htMappedGetN(HtMapped *htMapped, const char *key, size_t len, size_t *size);
+
+/**
+ * Same of htMappedGetN() function with a null-terminated 'key' key.
+ * @param[in] htMapped
+ * @param[in] key
+ * @param[out] size
+ * @return const void*
+ */
+const void *htMappedGet(HtMapped *htMapped, const char *key, size_t *size);
+
+/**
+ * Return the value of the item at the 'idx' index, which goes from zero to<br>
+ * HtMapped::numOfItems - 1, NULL if the index is out of range.<br>
+ * If 'key' is not NULL, it is set to the null-terminated key of the item.<br>
+ * If 'size' is not NULL, it is set to the value size.
+ * @param[in] htMapped
+ * @param[in] idx
+ * @param[out] key
+ * @param[out] size
+ * @return const void*
+ */
+const void *htMappedGetAt(HtMapped *htMapped, int idx, const char **key, size_t *size);
+
+/**
+ * Return a new thread safe hash table with 'numOfShards' shards of 'type' type.<br>
+ * The number of shards is rounded up to a power of 2, use a few times the number of the cores.<br>
+ * The 'initialCapacity' capacity and the 'releaseFn' release function are the ones<br>
+ * of every shard.<br>
+ * The values returned by the lookups are not protected: with a release function,<br>
+ * a value must not be used if another thread could remove or replace it.<br>
+ * It must be freed by htConcurrentRelease() function.
+ * @param[in] type
+ * @param[in] numOfShards
+ * @param[in] initialCapacity
+ * @param[in] releaseFn
+ * @return HtConcurrent*
+ */
+HtConcurrent *htConcurrentNew(HtType type, int numOfShards, int initialCapacity,
+                              void (*releaseFn)(void **));
+
+/**
+ * Release the 'htConcurrent' hash table.<br>
+ * No other thread must use it.
+ * @param[in] htConcurrent
+ */
+void htConcurrentRelease(HtConcurrent **htConcurrent);
+
+/**
+ * Same of htGetN() function, the shard of the key is locked for reading.
+ * @param[in] htConcurrent
+ * @param[in] key
+ * @param[in] len
+ * @return void*
+ */
+void *htConcurrentGetN(HtConcurrent *htConcurrent, const char *key, size_t len);
+
+/**
+ * Same of htGet() function, the shard of the key is locked for reading.
+ * @param[in] htConcurrent
+ * @param[in] key
+ * @return void*
+ */
+void *htConcurrentGet(HtConcurrent *htConcurrent, const char *key);
+
+/**
+ * Same of htAddN() function, the shard of the key is locked for writing.
+ * @param[in] htConcurrent
+ * @param[in] key
+ * @param[in] len
+ * @param[in] value
+ * @return true/false
+ */
+bool htConcurrentAddN(HtConcurrent *htConcurrent, const char *key, size_t len, void *value);
+
+/**
+ * Same of htAdd() function, the shard of the key is locked for writing.
+ * @param[in] htConcurrent
+ * @param[in] key
+ * @param[in] value
+ * @return true/false
+ */
+bool htConcurrentAdd(HtConcurrent *htConcurrent, const char *key, void *value);
+
+/**
+ * Same of htGetOrAddN() function, the shard of the key is locked for writing<br>
+ * so the lookup and the addition are atomic.
+ * @param[in] htConcurrent
+ * @param[in] key
+ * @param[in] len
+ * @param[in] value
+ * @param[out] added
+ * @return void*
+ */
+void *htConcurrentGetOrAddN(HtConcurrent *htConcurrent, const char *key, size_t len, void *value,
+                            bool *added);
+
+/**
+ * Same of htGetOrAdd() function, the shard of the key is locked for writing<br>
+ * so the lookup and the addition are atomic.
+ * @param[in] htConcurrent
+ * @param[in] key
+ * @param[in] value
+ * @param[out] added
+ * @return void*
+ */
+void *htConcurrentGetOrAdd(HtConcurrent *htConcurrent, const char *key, void *value,
+                           bool *added);
+
+/**
+ * Same of htRemoveN() function, the shard of the key is locked for writing.
+ * @param[in] htConcurrent
+ * @param[in] key
+ * @param[in] len
+ * @return true/false
+ */
+bool htConcurrentRemoveN(HtConcurrent *htConcurrent, const char *key, size_t len);
+
+/**
+ * Same of htRemove() function, the shard of the key is locked for writing.
+ * @param[in] htConcurrent
+ * @param[in] key
+ * @return true/false
+ */
+bool htConcurrentRemove(HtConcurrent *htConcurrent, const char *key);
+
+/**
+ * Same of htSetN() function, the shard of the key is locked for writing.
+ * @param[in] htConcurrent
+ * @param[in] key
+ * @param[in] len
+ * @param[in] value
+ * @return true/false
+ */
+bool htConcurrentSetN(HtConcurrent *htConcurrent, const char *key, size_t len, void *value);
+
+/**
+ * Same of htSet() function, the shard of the key is locked for writing.
+ * @param[in] htConcurrent
+ * @param[in] key
+ * @param[in] value
+ * @return true/false
+ */
+bool htConcurrentSet(HtConcurrent *htConcurrent, const char *key, void *value);
+
+/**
+ * Return the number of the items of the 'htConcurrent' hash table.<br>
+ * The shards are locked one at a time, thus the result is not a snapshot<br>
+ * if other threads are modifying the hash table.
+ * @param[in] htConcurrent
+ * @return int
+ */
+int htConcurrentNumOfItems(HtConcurrent *htConcurrent);
+
+/**
+ * Return a new read-mostly thread safe hash table which takes the ownership of the 'ht'<br>
+ * hash table, built by a single thread.<br>
+ * The 'ht' pointer is set to NULL and an eventual rehashing in progress is completed.<br>
+ * Every thread which performs a lookup uses a thread specific key until the hash table release.<br>
+ * It must be freed by htRcuRelease() function.
+ * @param[in] ht
+ * @return HtRcu*
+ */
+HtRcu *htRcuNew(Ht **ht);
+
+/**
+ * Release the 'htRcu' hash table.<br>
+ * No other thread must use it.
+ * @param[in] htRcu
+ */
+void htRcuRelease(HtRcu **htRcu);
+
+/**
+ * Start a read-side section of the 'htRcu' hash table for the calling thread.<br>
+ * The values returned by the lookups can be used until htRcuReadUnlock() function is called,<br>
+ * even if another thread removes or replaces them.<br>
+ * The sections can be nested and must be short: the modifications wait for them.<br>
+ * A modification must not be called inside a section.
+ * @param[in] htRcu
+ */
+void htRcuReadLock(HtRcu *htRcu);
+
+/**
+ * End the read-side section of the 'htRcu' hash table for the calling thread.
+ * @param[in] htRcu
+ */
+void htRcuReadUnlock(HtRcu *htRcu);
+
+/**
+ * Same of htGetN() function without any lock.<br>
+ * Outside of a read-side section, the returned value is not protected: with a release function,<br>
+ * it must not be used if another thread could remove or replace it.
+ * @param[in] htRcu
+ * @param[in] key
+ * @param[in] len
+ * @return void*
+ */
+void *htRcuGetN(HtRcu *htRcu, const char *key, size_t len);
+
+/**
+ * Same of htGet() function without any lock.
+ * @param[in] htRcu
+ * @param[in] key
+ * @return void*
+ */
+void *htRcuGet(HtRcu *htRcu, const char *key);
+
+/**
+ * Same of htAddN() function, the writers are serialized.
+ * @param[in] htRcu
+ * @param[in] key
+ * @param[in] len
+ * @param[in] value
+ * @return true/false
+ */
+bool htRcuAddN(HtRcu *htRcu, const char *key, size_t len, void *value);
+
+/**
+ * Same of htAdd() function, the writers are serialized.
+ * @param[in] htRcu
+ * @param[in] key
+ * @param[in] value
+ * @return true/false
+ */
+bool htRcuAdd(HtRcu *htRcu, const char *key, void *value);
+
+/**
+ * Same of htRemoveN() function, the writers are serialized.<br>
+ * The value is released when no lookup can return it anymore.
+ * @param[in] htRcu
+ * @param[in] key
+ * @param[in] len
+ * @return true/false
+ */
+bool htRcuRemoveN(HtRcu *htRcu, const char *key, size_t len);
+
+/**
+ * Same of htRemove() function, the writers are serialized.<br>
+ * The value is released when no lookup can return it anymore.
+ * @param[in] htRcu
+ * @param[in] key
+ * @return true/false
+ */
+bool htRcuRemove(HtRcu *htRcu, const char *key);
+
+/**
+ * Same of htSetN() function, the writers are serialized.<br>
+ * The previous value is released when no lookup can return it anymore.
+ * @param[in] htRcu
+ * @param[in] key
+ * @param[in] len
+ * @param[in] value
+ * @return true/false
+ */
+bool htRcuSetN(HtRcu *htRcu, const char *key, size_t len, void *value);
+
+/**
+ * Same of htSet() function, the writers are serialized.<br>
+ * The previous value is released when no lookup can return it anymore.
+ * @param[in] htRcu
+ * @param[in] key
+ * @param[in] value
+ * @return true/false
+ */
+bool htRcuSet(HtRcu *htRcu, const char *key, void *value);
+
+// HTINT
+
+/**
+ * Return a hash table whose keys are 64 bit integers.<br>
+ * @param[in] initialCapacity
+ * @param[in] releaseFn the function to release the values (optional)
+ * @return HtInt
+ */
+HtInt *htIntNew(int initialCapacity, void (*releaseFn)(void **));
+
+/**
+ * Return a hash table whose keys are 64 bit integers which follows the resize policy<br>
+ * given by 'policy' (see htNewWithPolicy()).<br>
+ * If 'policy' is NULL, the default policy is used.<br>
+ * Return NULL if the policy is not valid.
+ * @param[in] initialCapacity
+ * @param[in] releaseFn the function to release the values (optional)
+ * @param[in] policy
+ * @return HtInt
+ */
+HtInt *htIntNewWithPolicy(int initialCapacity, void (*releaseFn)(void **),
+                          const HtPolicy *policy);
+
+/**
+ * Release the hash table and its values if the release function is defined.
+ * @param[in] htInt
+ */
+void htIntRelease(HtInt **htInt);
+
+/**
+ * Return the value of the key or NULL if it doesn't exist.
+ * @param[in] htInt
+ * @param[in] key
+ * @return void*
+ */
+void *htIntGet(HtInt *htInt, uint64_t key);
+
+/**
+ * Add the item to the hash table.<br>
+ * Return false if the key already exists.
+ * @param[in] htInt
+ * @param[in] key
+ * @param[in] value
+ * @return true/false
+ */
+bool htIntAdd(HtInt *htInt, uint64_t key, void *value);
+
+/**
+ * Same of htGetOrAdd() function for a HtInt hash table.
+ * @param[in] htInt
+ * @param[in] key
+ * @param[in] value
+ * @param[out] added (optional)
+ * @return void*
+ */
+void *htIntGetOrAdd(HtInt *htInt, uint64_t key, void *value, bool *added);
+
+/**
+ * Remove the item releasing its value if the release function is defined.<br>
+ * Return false if the key doesn't exist.
+ * @param[in] htInt
+ * @param[in] key
+ * @return true/false
+ */
+bool htIntRemove(HtInt *htInt, uint64_t key);
+
+/**
+ * Replace the value of the key releasing the previous one if the release function is defined.<br>
+ * Return false if the key doesn't exist.
+ * @param[in] htInt
+ * @param[in] key
+ * @param[in] value
+ * @return true/false
+ */
+bool htIntSet(HtInt *htInt, uint64_t key, void *value);
+
+/**
+ * Initialize an iterator of the hash table.
+ * @param[in] htInt
+ * @param[out] htIntIter
+ */
+void htIntIterInit(HtInt *htInt, HtIntIterator *htIntIter);
+
+/**
+ * Get the key and the value of the next item.<br>
+ * Return false if the iterator is terminated or the hash table has been modified<br>
+ * (added or removed items) after the iterator initialization.
+ * @param[in] htIntIter
+ * @param[out] key (optional)
+ * @param[out] value (optional)
+ * @return true/false
+ */
+bool htIntIterNext(HtIntIterator *htIntIter, uint64_t *key, void **value);
+
+// HTPTR
+
+/**
+ * Return a hash table whose keys are pointers compared by identity.<br>
+ * @param[in] initialCapacity
+ * @param[in] releaseFn the function to release the values (optional)
+ * @return HtPtr
+ */
+HtPtr *htPtrNew(int initialCapacity, void (*releaseFn)(void **));
+
+/**
+ * Return a hash table whose keys are pointers which follows the resize policy<br>
+ * given by 'policy' (see htNewWithPolicy()).<br>
+ * If 'policy' is NULL, the default policy is used.<br>
+ * Return NULL if the policy is not valid.
+ * @param[in] initialCapacity
+ * @param[in] releaseFn the function to release the values (optional)
+ * @param[in] policy
+ * @return HtPtr
+ */
+HtPtr *htPtrNewWithPolicy(int initialCapacity, void (*releaseFn)(void **),
+                          const HtPolicy *policy);
+
+/**
+ * Release the hash table and its values if the release function is defined.
+ * @param[in] htPtr
+ */
+void htPtrRelease(HtPtr **htPtr);
+
+/**
+ * Return the value of the key or NULL if it doesn't exist.
+ * @param[in] htPtr
+ * @param[in] key
+ * @return void*
+ */
+void *htPtrGet(HtPtr *htPtr, const void *key);
+
+/**
+ * Add the item to the hash table.<br>
+ * Return false if the key already exists.
+ * @param[in] htPtr
+ * @param[in] key
+ * @param[in] value
+ * @return true/false
+ */
+bool htPtrAdd(HtPtr *htPtr, const void *key, void *value);
+
+/**
+ * Same of htGetOrAdd() function for a HtPtr hash table.
+ * @param[in] htPtr
+ * @param[in] key
+ * @param[in] value
+ * @param[out] added (optional)
+ * @return void*
+ */
+void *htPtrGetOrAdd(HtPtr *htPtr, const void *key, void *value, bool *added);
+
+/**
+ * Remove the item releasing its value if the release function is defined.<br>
+ * Return false if the key doesn't exist.
+ * @param[in] htPtr
+ * @param[in] key
+ * @return true/false
+ */
+bool htPtrRemove(HtPtr *htPtr, const void *key);
+
+/**
+ * Replace the value of the key releasing the previous one if the release function is defined.<br>
+ * Return false if the key doesn't exist.
+ * @param[in] htPtr
+ * @param[in] key
+ * @param[in] value
+ * @return true/false
+ */
+bool htPtrSet(HtPtr *htPtr, const void *key, void *value);
+
+/**
+ * Initialize an iterator of the hash table.
+ * @param[in] htPtr
+ * @param[out] htPtrIter
+ */
+void htPtrIterInit(HtPtr *htPtr, HtIntIterator *htPtrIter);
+
+/**
+ * Get the key and the value of the next item.<br>
+ * Return false if the iterator is terminated or the hash table has been modified<br>
+ * (added or removed items) after the iterator initialization.
+ * @param[in] htPtrIter
+ * @param[out] key (optional)
+ * @param[out] value (optional)
+ * @return true/false
+ */
+bool htPtrIterNext(HtIntIterator *htPtrIter, const void **key, void **value);
+
+// STRSET
+
+/**
+ * Return an empty hash set.
+ * @param[in] initialCapacity
+ * @return StrSet
+ */
+StrSet *strSetNew(int initialCapacity);
+
+/**
+ * Return an empty hash set which follows the resize policy given by 'policy'<br>
+ * (see htNewWithPolicy()).<br>
+ * If 'policy' is NULL, the default policy is used.<br>
+ * The union and the intersection follow the policy of the first set and the smaller set.<br>
+ * Return NULL if the policy is not valid.
+ * @param[in] initialCapacity
+ * @param[in] policy
+ * @return StrSet
+ */
+StrSet *strSetNewWithPolicy(int initialCapacity, const HtPolicy *policy);
+
+/**
+ * Release the hash set and its keys.
+ * @param[in] strSet
+ */
+void strSetRelease(StrSet **strSet);
+
+/**
+ * Add the key to the hash set, the key is copied.<br>
+ * Return false if the key is NULL, empty or it already exists.
+ * @param[in] strSet
+ * @param[in] key
+ * @return true/false
+ */
+bool strSetAdd(StrSet *strSet, const char *key);
+
+/**
+ * Return true if the key exists into the hash set, false otherwise.
+ * @param[in] strSet
+ * @param[in] key
+ * @return true/false
+ */
+bool strSetContains(StrSet *strSet, const char *key);
+
+/**
+ * Remove the key from the hash set.<br>
+ * Return false if the key doesn't exist.
+ * @param[in] strSet
+ * @param[in] key
+ * @return true/false
+ */
+bool strSetRemove(StrSet *strSet, const char *key);
+
+/**
+ * Return a new hash set which contains the keys of the hash sets.
+ * @param[in] strSet1
+ * @param[in] strSet2
+ * @return StrSet
+ */
+StrSet *strSetUnion(StrSet *strSet1, StrSet *strSet2);
+
+/**
+ * Return a new hash set which contains the keys present into both the hash sets.<br>
+ * The smaller hash set is scanned and the keys are searched into the other one.
+ * @param[in] strSet1
+ * @param[in] strSet2
+ * @return StrSet
+ */
+StrSet *strSetIntersection(StrSet *strSet1, StrSet *strSet2);
+
+/**
+ * Initialize an iterator of the hash set.
+ * @param[in] strSet
+ * @param[out] strSetIter
+ */
+void strSetIterInit(StrSet *strSet, StrSetIterator *strSetIter);
+
+/**
+ * Get the next key of the hash set.<br>
+ * Return false if the iterator is terminated or the hash set has been modified<br>
+ * after the iterator initialization.
+ * @param[in] strSetIter
+ * @param[out] key
+ * @return true/false
+ */
+bool strSetIterNext(StrSetIterator *strSetIter, const char **key);
+
+// ORDMAP
+
+/**
+ * Return an empty ordered map.<br>
+ * @param[in] releaseFn the function to release the values (optional)
+ * @return OrdMap
+ */
+OrdMap *ordMapNew(void (*releaseFn)(void **));
+
+/**
+ * Release the ordered map, its keys and its values if the release function is defined.
+ * @param[in] ordMap
+ */
+void ordMapRelease(OrdMap **ordMap);
+
+/**
+ * Return the value of the key or NULL if it doesn't exist.<br>
+ * It costs O(log n).
+ * @param[in] ordMap
+ * @param[in] key
+ * @return void*
+ */
+void *ordMapGet(OrdMap *ordMap, const char *key);
+
+/**
+ * Add the item to the ordered map, the key is copied.<br>
+ * Return false if the key is NULL, empty or it already exists.
+ * @param[in] ordMap
+ * @param[in] key
+ * @param[in] value
+ * @return true/false
+ */
+bool ordMapAdd(OrdMap *ordMap, const char *key, void *value);
+
+/**
+ * Replace the value of the key releasing the previous one if the release function is defined.<br>
+ * Return false if the key doesn't exist.
+ * @param[in] ordMap
+ * @param[in] key
+ * @param[in] value
+ * @return true/false
+ */
+bool ordMapSet(OrdMap *ordMap, const char *key, void *value);
+
+/**
+ * Remove the item releasing its value if the release function is defined.<br>
+ * Return false if the key doesn't exist.
+ * @param[in] ordMap
+ * @param[in] key
+ * @return true/false
+ */
+bool ordMapRemove(OrdMap *ordMap, const char *key);
+
+/**
+ * Initialize the iterator to the first item in keys order.
+ * @param[in] ordMap
+ * @param[in] ordMapIter
+ */
+void ordMapIterFirst(OrdMap *ordMap, OrdMapIterator *ordMapIter);
+
+/**
+ * Initialize the iterator to the first item whose key is greater than or equal to the key.
+ * @param[in] ordMap
+ * @param[in] ordMapIter
+ * @param[in] key
+ */
+void ordMapIterLowerBound(OrdMap *ordMap, OrdMapIterator *ordMapIter, const char *key);
+
+/**
+ * Initialize the iterator to the items whose key starts with the prefix.<br>
+ * The prefix is not copied, it must be valid until the end of the iteration.
+ * @param[in] ordMap
+ * @param[in] ordMapIter
+ * @param[in] prefix
+ */
+void ordMapIterPrefix(OrdMap *ordMap, OrdMapIterator *ordMapIter, const char *prefix);
+
+/**
+ * Get the next item in keys order.<br>
+ * Return false at the end of the iteration or if the ordered map has been modified<br>
+ * by an addition or a remotion after the iterator initialization.
+ * @param[in] ordMapIter
+ * @param[out] key (optional)
+ * @param[out] value (optional)
+ * @return true/false
+ */
+bool ordMapIterNext(OrdMapIterator *ordMapIter, const char **key, void **value);
+
 // PARSER
 
 /**
@@ -0,0 +1,413 @@
+/*
+(C) 2021 by Domenico Panella <pandom79@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 3.
+See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
+*/
+
+#include "uordmap.h"
+
+static OrdMapNode *ordMapNodeNew(bool leaf)
+{
+    OrdMapNode *node = calloc(1, sizeof(OrdMapNode));
+    assert(node);
+    node->leaf = leaf;
+
+    return node;
+}
+
+static void ordMapNodeRelease(OrdMapNode **node, void (*releaseFn)(void **))
+{
+    if (*node) {
+        for (int i = 0; i < (*node)->size; i++) {
+            objectRelease(&(*node)->keys[i]);
+            if ((*node)->leaf && releaseFn)
+                (*releaseFn)(&(*node)->values[i]);
+        }
+        if (!(*node)->leaf) {
+            for (int i = 0; i <= (*node)->size; i++)
+                ordMapNodeRelease(&(*node)->children[i], releaseFn);
+        }
+        objectRelease(node);
+    }
+}
+
+static int ordMapLowerIdx(OrdMapNode *node, const char *key)
+{
+    /* Index of the first key greater than or equal to 'key' */
+    int lo = 0, hi = node->size;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (strcmp(node->keys[mid], key) < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+static int ordMapChildIdx(OrdMapNode *node, const char *key)
+{
+    /* Index of the first separator greater than 'key', which is also the child index. */
+    int lo = 0, hi = node->size;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (strcmp(node->keys[mid], key) <= 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+static OrdMapNode *ordMapFindLeaf(OrdMap *ordMap, const char *key)
+{
+    OrdMapNode *node = ordMap->root;
+    while (!node->leaf)
+        node = node->children[ordMapChildIdx(node, key)];
+
+    return node;
+}
+
+/* INSERTION */
+
+static OrdMapNode *ordMapSplit(OrdMapNode *node, char **separator)
+{
+    OrdMapNode *right = ordMapNodeNew(node->leaf);
+    if (node->leaf) {
+        int half = node->size / 2;
+        right->size = node->size - half;
+        memcpy(right->keys, &node->keys[half], right->size * sizeof(char *));
+        memcpy(right->values, &node->values[half], right->size * sizeof(void *));
+        node->size = half;
+        right->prev = node;
+        right->next = node->next;
+        if (node->next)
+            node->next->prev = right;
+        node->next = right;
+        /* The separator is a copy, the first key of the right leaf could be removed. */
+        *separator = stringNew(right->keys[0]);
+    } else {
+        /* The middle key moves up to the parent. */
+        int mid = node->size / 2;
+        right->size = node->size - mid - 1;
+        memcpy(right->keys, &node->keys[mid + 1], right->size * sizeof(char *));
+        memcpy(right->children, &node->children[mid + 1], (right->size + 1) * sizeof(OrdMapNode *));
+        *separator = node->keys[mid];
+        node->size = mid;
+    }
+
+    return right;
+}
+
+static OrdMapNode *ordMapInsert(OrdMapNode *node, const char *key, void *value, char **separator,
+                                bool *added)
+{
+    if (node->leaf) {
+        int idx = ordMapLowerIdx(node, key);
+        if (idx < node->size && strcmp(node->keys[idx], key) == 0) {
+            *added = false;
+            return NULL;
+        }
+        memmove(&node->keys[idx + 1], &node->keys[idx], (node->size - idx) * sizeof(char *));
+        memmove(&node->values[idx + 1], &node->values[idx], (node->size - idx) * sizeof(void *));
+        node->keys[idx] = stringNew(key);
+        node->values[idx] = value;
+        node->size++;
+        *added = true;
+        return node->size > ORD_MAP_ORDER ? ordMapSplit(node, separator) : NULL;
+    }
+
+    int idx = ordMapChildIdx(node, key);
+    char *childSeparator = NULL;
+    OrdMapNode *right = ordMapInsert(node->children[idx], key, value, &childSeparator, added);
+    if (!right)
+        return NULL;
+    memmove(&node->keys[idx + 1], &node->keys[idx], (node->size - idx) * sizeof(char *));
+    memmove(&node->children[idx + 2], &node->children[idx + 1],
+            (node->size - idx) * sizeof(OrdMapNode *));
+    node->keys[idx] = childSeparator;
+    node->children[idx + 1] = right;
+    node->size++;
+
+    return node->size + 1 > ORD_MAP_ORDER ? ordMapSplit(node, separator) : NULL;
+}
+
+/* REMOTION */
+
+static inline bool ordMapUnderflow(OrdMapNode *node, int delta)
+{
+    /* The items of a leaf or the children of an internal node */
+    return (node->leaf ? node->size : node->size + 1) - delta < ORD_MAP_MIN;
+}
+
+static void ordMapBorrowLeft(OrdMapNode *parent, int idx)
+{
+    OrdMapNode *child = parent->children[idx], *left = parent->children[idx - 1];
+    memmove(&child->keys[1], &child->keys[0], child->size * sizeof(char *));
+    if (child->leaf) {
+        memmove(&child->values[1], &child->values[0], child->size * sizeof(void *));
+        child->keys[0] = left->keys[left->size - 1];
+        child->values[0] = left->values[left->size - 1];
+        objectRelease(&parent->keys[idx - 1]);
+        parent->keys[idx - 1] = stringNew(child->keys[0]);
+    } else {
+        memmove(&child->children[1], &child->children[0], (child->size + 1) * sizeof(OrdMapNode *));
+        child->keys[0] = parent->keys[idx - 1];
+        child->children[0] = left->children[left->size];
+        parent->keys[idx - 1] = left->keys[left->size - 1];
+    }
+    left->size--;
+    child->size++;
+}
+
+static void ordMapBorrowRight(OrdMapNode *parent, int idx)
+{
+    OrdMapNode *child = parent->children[idx], *right = parent->children[idx + 1];
+    if (child->leaf) {
+        child->keys[child->size] = right->keys[0];
+        child->values[child->size] = right->values[0];
+        memmove(&right->values[0], &right->values[1], (right->size - 1) * sizeof(void *));
+    } else {
+        child->keys[child->size] = parent->keys[idx];
+        child->children[child->size + 1] = right->children[0];
+        parent->keys[idx] = right->keys[0];
+        memmove(&right->children[0], &right->children[1], right->size * sizeof(OrdMapNode *));
+    }
+    memmove(&right->keys[0], &right->keys[1], (right->size - 1) * sizeof(char *));
+    right->size--;
+    child->size++;
+    if (child->leaf) {
+        objectRelease(&parent->keys[idx]);
+        parent->keys[idx] = stringNew(right->keys[0]);
+    }
+}
+
+static void ordMapMerge(OrdMapNode *parent, int idx)
+{
+    /* The child 'idx + 1' is moved into the child 'idx'. */
+    OrdMapNode *left = parent->children[idx], *right = parent->children[idx + 1];
+    if (left->leaf) {
+        memcpy(&left->keys[left->size], right->keys, right->size * sizeof(char *));
+        memcpy(&left->values[left->size], right->values, right->size * sizeof(void *));
+        left->size += right->size;
+        left->next = right->next;
+        if (right->next)
+            right->next->prev = left;
+        objectRelease(&parent->keys[idx]);
+    } else {
+        left->keys[left->size] = parent->keys[idx];
+        memcpy(&left->keys[left->size + 1], right->keys, right->size * sizeof(char *));
+        memcpy(&left->children[left->size + 1], right->children,
+               (right->size + 1) * sizeof(OrdMapNode *));
+        left->size += right->size + 1;
+    }
+    memmove(&parent->keys[idx], &parent->keys[idx + 1], (parent->size - idx - 1) * sizeof(char *));
+    memmove(&parent->children[idx + 1], &parent->children[idx + 2],
+            (parent->size - idx - 1) * sizeof(OrdMapNode *));
+    parent->size--;
+    objectRelease(&right);
+}
+
+static void ordMapRebalance(OrdMapNode *parent, int idx)
+{
+    OrdMapNode *left = idx > 0 ? parent->children[idx - 1] : NULL;
+    OrdMapNode *right = idx < parent->size ? parent->children[idx + 1] : NULL;
+
+    if (left && !ordMapUnderflow(left, 1))
+        ordMapBorrowLeft(parent, idx);
+    else if (right && !ordMapUnderflow(right, 1))
+        ordMapBorrowRight(parent, idx);
+    else if (left)
+        ordMapMerge(parent, idx - 1);
+    else
+        ordMapMerge(parent, idx);
+}
+
+static bool ordMapDelete(OrdMap *ordMap, OrdMapNode *node, const char *key)
+{
+    if (node->leaf) {
+        int idx = ordMapLowerIdx(node, key);
+        if (idx == node->size || strcmp(node->keys[idx], key) != 0)
+            return false;
+        /* The separators equal to the key remain valid bounds, they are not changed. */
+        objectRelease(&node->keys[idx]);
+        if (ordMap->releaseFn)
+            (*ordMap->releaseFn)(&node->values[idx]);
+        memmove(&node->keys[idx], &node->keys[idx + 1], (node->size - idx - 1) * sizeof(char *));
+        memmove(&node->values[idx], &node->values[idx + 1],
+                (node->size - idx - 1) * sizeof(void *));
+        node->size--;
+        return true;
+    }
+
+    int idx = ordMapChildIdx(node, key);
+    if (!ordMapDelete(ordMap, node->children[idx], key))
+        return false;
+    if (ordMapUnderflow(node->children[idx], 0))
+        ordMapRebalance(node, idx);
+
+    return true;
+}
+
+/* PUBLIC */
+
+OrdMap *ordMapNew(void (*releaseFn)(void **))
+{
+    OrdMap *ordMap = calloc(1, sizeof(OrdMap));
+    assert(ordMap);
+    ordMap->root = ordMapNodeNew(true);
+    ordMap->releaseFn = releaseFn;
+
+    return ordMap;
+}
+
+void ordMapRelease(OrdMap **ordMap)
+{
+    if (*ordMap) {
+        ordMapNodeRelease((OrdMapNode **)&(*ordMap)->root, (*ordMap)->releaseFn);
+        objectRelease(ordMap);
+    }
+}
+
+void *ordMapGet(OrdMap *ordMap, const char *key)
+{
+    if (ordMap && key) {
+        OrdMapNode *leaf = ordMapFindLeaf(ordMap, key);
+        int idx = ordMapLowerIdx(leaf, key);
+        if (idx < leaf->size && strcmp(leaf->keys[idx], key) == 0)
+            return leaf->values[idx];
+    }
+
+    return NULL;
+}
+
+bool ordMapAdd(OrdMap *ordMap, const char *key, void *value)
+{
+    if (ordMap && key && *key) {
+        bool added = false;
+        char *separator = NULL;
+        OrdMapNode *root = ordMap->root;
+        OrdMapNode *right = ordMapInsert(root, key, value, &separator, &added);
+        if (right) {
+            /* The tree grows from the root. */
+            OrdMapNode *newRoot = ordMapNodeNew(false);
+            newRoot->size = 1;
+            newRoot->keys[0] = separator;
+            newRoot->children[0] = root;
+            newRoot->children[1] = right;
+            ordMap->root = newRoot;
+        }
+        if (added) {
+            ordMap->numOfItems++;
+            ordMap->version++;
+        }
+        return added;
+    }
+
+    return false;
+}
+
+bool ordMapSet(OrdMap *ordMap, const char *key, void *value)
+{
+    if (ordMap && key) {
+        OrdMapNode *leaf = ordMapFindLeaf(ordMap, key);
+        int idx = ordMapLowerIdx(leaf, key);
+        if (idx < leaf->size && strcmp(leaf->keys[idx], key) == 0) {
+            if (ordMap->releaseFn)
+                (*ordMap->releaseFn)(&leaf->values[idx]);
+            leaf->values[idx] = value;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool ordMapRemove(OrdMap *ordMap, const char *key)
+{
+    if (ordMap && key && ordMapDelete(ordMap, ordMap->root, key)) {
+        OrdMapNode *root = ordMap->root;
+        /* The tree shrinks from the root. */
+        if (!root->leaf && root->size == 0) {
+            ordMap->root = root->children[0];
+            objectRelease(&root);
+        }
+        ordMap->numOfItems--;
+        ordMap->version++;
+        return true;
+    }
+
+    return false;
+}
+
+void ordMapIterFirst(OrdMap *ordMap, OrdMapIterator *ordMapIter)
+{
+    if (ordMap && ordMapIter) {
+        OrdMapNode *node = ordMap->root;
+        while (!node->leaf)
+            node = node->children[0];
+        ordMapIter->ordMap = ordMap;
+        ordMapIter->node = node;
+        ordMapIter->idx = 0;
+        ordMapIter->prefix = NULL;
+        ordMapIter->prefixLen = 0;
+        ordMapIter->version = ordMap->version;
+    }
+}
+
+void ordMapIterLowerBound(OrdMap *ordMap, OrdMapIterator *ordMapIter, const char *key)
+{
+    if (ordMap && ordMapIter && key) {
+        OrdMapNode *leaf = ordMapFindLeaf(ordMap, key);
+        ordMapIter->ordMap = ordMap;
+        ordMapIter->node = leaf;
+        ordMapIter->idx = ordMapLowerIdx(leaf, key);
+        ordMapIter->prefix = NULL;
+        ordMapIter->prefixLen = 0;
+        ordMapIter->version = ordMap->version;
+    }
+}
+
+void ordMapIterPrefix(OrdMap *ordMap, OrdMapIterator *ordMapIter, const char *prefix)
+{
+    if (ordMap && ordMapIter && prefix) {
+        /* The keys with the prefix are the first ones not less than the prefix. */
+        ordMapIterLowerBound(ordMap, ordMapIter, prefix);
+        ordMapIter->prefix = prefix;
+        ordMapIter->prefixLen = strlen(prefix);
+    }
+}
+
+bool ordMapIterNext(OrdMapIterator *ordMapIter, const char **key, void **value)
+{
+    /* The ordered map must not be modified after the iterator initialization. */
+    if (ordMapIter && ordMapIter->node && ordMapIter->version == ordMapIter->ordMap->version) {
+        OrdMapNode *leaf = ordMapIter->node;
+        if (ordMapIter->idx == leaf->size) {
+            /* Only an empty root is an empty leaf. */
+            leaf = leaf->next;
+            ordMapIter->node = leaf;
+            ordMapIter->idx = 0;
+            if (!leaf)
+                return false;
+        }
+        const char *itemKey = leaf->keys[ordMapIter->idx];
+        if (ordMapIter->prefixLen > 0 &&
+            strncmp(itemKey, ordMapIter->prefix, ordMapIter->prefixLen) != 0) {
+            ordMapIter->node = NULL;
+            return false;
+        }
+        if (key)
+            *key = itemKey;
+        if (value)
+            *value = leaf->values[ordMapIter->idx];
+        ordMapIter->idx++;
+        return true;
+    }
+
+    return false;
+}
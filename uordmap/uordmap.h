@@ -0,0 +1,53 @@
+/*
+(C) 2021 by Domenico Panella <pandom79@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License version 3.
+See http://www.gnu.org/licenses/gpl-3.0.html for full license text.
+*/
+
+#ifndef UORDMAP_H
+#define UORDMAP_H
+
+#include "../ulib.h"
+
+/* Maximum number of the items of a leaf and of the children of an internal node. */
+#define ORD_MAP_ORDER 32
+/* Minimum number of the items of a leaf and of the children of an internal node (not root). */
+#define ORD_MAP_MIN (ORD_MAP_ORDER / 2)
+
+/** @struct OrdMapNode
+ *  @brief This structure represents a node of the ordered map B+ tree.<br>
+ *  The items are stored into the leaves only, which are linked in keys order.<br>
+ *  The child 'i' of an internal node contains the keys between keys[i - 1] (included)<br>
+ *  and keys[i] (excluded).<br>
+ *  Every array has a further element for the overflow before a split.
+ *  @var OrdMapNode::leaf
+ *  It represents true if the node is a leaf.
+ *  @var OrdMapNode::size
+ *  It represents the number of the keys.
+ *  @var OrdMapNode::keys
+ *  It represents the item keys (leaf) or the separator keys (internal node).<br>
+ *  Every key is an own copy.
+ *  @var OrdMapNode::values
+ *  It represents the item values (leaf only).
+ *  @var OrdMapNode::children
+ *  It represents the children (internal node only), they are size + 1.
+ *  @var OrdMapNode::prev
+ *  It represents the previous leaf.
+ *  @var OrdMapNode::next
+ *  It represents the next leaf.
+ */
+typedef struct OrdMapNode {
+    bool leaf;
+    int size;
+    char *keys[ORD_MAP_ORDER + 1];
+    union {
+        void *values[ORD_MAP_ORDER + 1];
+        struct OrdMapNode *children[ORD_MAP_ORDER + 1];
+    };
+    struct OrdMapNode *prev;
+    struct OrdMapNode *next;
+} OrdMapNode;
+
+#endif // UORDMAP_H